@@ -0,0 +1,126 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <concepts>
+#include <string_view>
+#include <source_location>
+#include <format>
+
+namespace warp::log {
+
+/// Static descriptor of a log call site, interned once per source location
+struct CallSite {
+  const char*           file     {""}; // file name without directories
+  const char*           function {""};
+  uint32_t              line     {0};
+  uint32_t              column   {0};
+  uint32_t              id       {0};  // dense, stable for the process : usable instead of the strings
+  std::atomic<uint64_t> hits     {0};  // lines emitted from this site
+};
+
+} // namespace warp::log
+
+namespace warp::log::internal {
+
+/// --- Call site utils ---
+
+/// Change below constant if needed : must be a power of two
+inline constexpr size_t CALL_SITE_CAPACITY {2048};
+
+struct CallSiteSlot {
+  std::atomic<uint64_t> key   {0}; // 0 : empty
+  std::atomic<bool>     ready {false};
+  CallSite              site  {};
+};
+
+inline constinit CallSiteSlot          s_call_sites[CALL_SITE_CAPACITY] {};
+inline constinit std::atomic<uint32_t> s_call_site_count                {0};
+
+[[nodiscard]] inline constexpr const char* fileBaseName(const char* path) noexcept {
+  const char* base {path};
+  for (const char* it {path}; *it; ++it) if (*it == '/' || *it == '\\') base = it + 1;
+  return base;
+}
+
+[[nodiscard]] inline uint64_t callSiteKey(const std::source_location& loc) noexcept {
+  uint64_t key {reinterpret_cast<uintptr_t>(loc.file_name())};
+  key ^= (static_cast<uint64_t>(loc.line()) << 32 | loc.column()) * 0x9E3779B97F4A7C15ull;
+  key ^= key >> 29;
+  return key | 1; // never the empty key
+}
+
+[[nodiscard]] inline bool isSameSite(const CallSite& site, const std::source_location& loc) noexcept {
+  return site.line == loc.line() && site.column == loc.column() && std::strcmp(site.file, fileBaseName(loc.file_name())) == 0;
+}
+
+/// Lock free lookup, the first call from a site fills its slot
+/// Returns nullptr once the table is full
+[[nodiscard]] inline CallSite* internCallSite(const std::source_location& loc) noexcept {
+  const uint64_t KEY {callSiteKey(loc)};
+
+  for (size_t probe {0}, i {KEY}; probe < CALL_SITE_CAPACITY; ++probe, ++i) {
+    CallSiteSlot& slot {s_call_sites[i & (CALL_SITE_CAPACITY - 1)]};
+    uint64_t key {slot.key.load(std::memory_order_acquire)};
+
+    if (key == 0 && slot.key.compare_exchange_strong(key, KEY, std::memory_order_acq_rel)) {
+      slot.site.file     = fileBaseName(loc.file_name());
+      slot.site.function = loc.function_name();
+      slot.site.line     = loc.line();
+      slot.site.column   = loc.column();
+      slot.site.id       = s_call_site_count.fetch_add(1, std::memory_order_relaxed);
+      slot.ready.store(true, std::memory_order_release);
+      return &slot.site;
+    }
+
+    if (key == KEY) {
+      while (!slot.ready.load(std::memory_order_acquire)) {} // another thread is filling it
+      if (isSameSite(slot.site, loc)) return &slot.site;
+      // colliding key of another site : keep probing
+    }
+  }
+
+  return nullptr;
+}
+
+/// Interns the site and counts the emitted line
+inline CallSite* touchCallSite(const std::source_location& loc) noexcept {
+  CallSite* site {internCallSite(loc)};
+  if (site) site->hits.fetch_add(1, std::memory_order_relaxed);
+  return site;
+}
+
+/// Format string that also captures the caller's location
+template <typename... Args>
+struct FormatAt {
+  std::format_string<Args...> fmt;
+  std::source_location        loc;
+
+  template <typename S> requires std::convertible_to<const S&, std::string_view>
+  consteval FormatAt(const S& str, std::source_location where = std::source_location::current())
+  : fmt {str}, loc {where} {}
+};
+
+/// Plain message that also captures the caller's location
+struct MessageAt {
+  std::string_view     msg;
+  std::source_location loc;
+
+  template <typename S> requires std::convertible_to<const S&, std::string_view>
+  MessageAt(const S& str, std::source_location where = std::source_location::current()) noexcept
+  : msg {str}, loc {where} {}
+};
+
+} // namespace warp::log::internal
+
+namespace warp::log {
+
+/// Visits every interned call site, e.g. to write the id table of a binary log
+template <typename Fn>
+inline void forEachCallSite(Fn&& fn) {
+  for (internal::CallSiteSlot& slot : internal::s_call_sites)
+    if (slot.ready.load(std::memory_order_acquire)) fn(static_cast<const CallSite&>(slot.site));
+}
+
+} // namespace warp::log
@@ -0,0 +1,141 @@
+#pragma once
+
+#include "misc.hpp"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdint>
+#include <iterator>
+#include <cstdlib>
+#include <string_view>
+
+namespace warp::log {
+
+/// Per module log level, declared once with `LOG_CATEGORY(name)`
+/// Own cache line so that checks never share it with other writes
+struct alignas(64) Category {
+  std::atomic<uint8_t> min_severity {0}; // everything enabled by default
+  const char*          NAME;
+  Category*            next         {nullptr};
+
+  constexpr explicit Category(const char* name) noexcept : NAME {name} {}
+
+  [[nodiscard]] bool isOn(Level lvl) const noexcept {
+    return internal::levelSeverity(lvl) >= min_severity.load(std::memory_order_relaxed);
+  }
+
+  void setLevel(Level lvl) noexcept { min_severity.store(internal::levelSeverity(lvl), std::memory_order_relaxed); }
+
+  bool registerSelf() noexcept;
+};
+
+} // namespace warp::log
+
+namespace warp::log::internal {
+
+/// --- Category utils ---
+
+/// Glob match supporting `*` and `?`
+[[nodiscard]] inline bool matchPattern(std::string_view pattern, std::string_view text) noexcept {
+  size_t p {0}, t {0}, star {std::string_view::npos}, retry {0};
+
+  while (t < text.size()) {
+    if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == text[t])) { ++p; ++t; }
+    else if (p < pattern.size() && pattern[p] == '*')                       { star = p++; retry = t; }
+    else if (star != std::string_view::npos)                                 { p = star + 1; t = ++retry; }
+    else return false;
+  }
+
+  while (p < pattern.size() && pattern[p] == '*') ++p;
+  return p == pattern.size();
+}
+
+/// Parses "trace", "debug", "info", "warn", "error", "fatal" in any case or "0" - "5", like warp_mini
+/// trace folds into Debug and fatal into Error, the nearest levels warp_log has
+[[nodiscard]] inline bool parseLevel(std::string_view text, Level& out) noexcept {
+  static constexpr std::string_view NAMES[] {"trace", "debug", "info", "warn", "error", "fatal"};
+  static constexpr Level            LEVELS[] {Level::Debug, Level::Debug, Level::Info, Level::Warn, Level::Error, Level::Error};
+
+  if (text.size() == 1 && text[0] >= '0' && text[0] <= '5') {
+    out = LEVELS[text[0] - '0'];
+    return true;
+  }
+
+  for (size_t i = 0; i < std::size(NAMES); ++i) {
+    if (text.size() != NAMES[i].size()) continue;
+
+    bool equal {true};
+    for (size_t c = 0; c < text.size() && equal; ++c) equal = (text[c] | 0x20) == NAMES[i][c];
+
+    if (equal) {
+      out = LEVELS[i];
+      return true;
+    }
+  }
+
+  return false;
+}
+
+/// Calls `fn(pattern, level_text)` for every non empty entry of a comma separated spec
+template <typename Fn>
+inline void forEachSpecEntry(std::string_view spec, Fn&& fn) noexcept {
+  while (!spec.empty()) {
+    const size_t COMMA {spec.find(',')};
+    const std::string_view ENTRY {spec.substr(0, COMMA)};
+    spec = (COMMA == std::string_view::npos) ? std::string_view {} : spec.substr(COMMA + 1);
+    if (ENTRY.empty()) continue;
+
+    const size_t EQ {ENTRY.find('=')};
+    fn(ENTRY, EQ == std::string_view::npos ? ENTRY : ENTRY.substr(0, EQ), EQ == std::string_view::npos ? std::string_view {} : ENTRY.substr(EQ + 1));
+  }
+}
+
+/// Applies every `pattern=level` entry of a comma separated spec that matches `category`
+inline void applyCategorySpec(std::string_view spec, Category& category) noexcept {
+  forEachSpecEntry(spec, [&category](std::string_view, std::string_view pattern, std::string_view level) {
+    Level lvl {};
+    if (matchPattern(pattern, category.NAME) && parseLevel(level, lvl)) category.setLevel(lvl);
+  });
+}
+
+/// Reports entries without `=` or with an unknown level on stderr, once per process
+inline bool reportBadCategorySpec(std::string_view spec) noexcept {
+  forEachSpecEntry(spec, [](std::string_view entry, std::string_view, std::string_view level) {
+    Level lvl {};
+    if (!parseLevel(level, lvl))
+      std::fprintf(stderr, "[WARP_LOG_CATEGORIES] ignoring \"%.*s\" : expected pattern=trace|debug|info|warn|error|fatal|0-5\n", static_cast<int>(entry.size()), entry.data());
+  });
+  return true;
+}
+
+} // namespace warp::log::internal
+
+namespace warp::log {
+
+/// Links the category into the registry and applies `WARP_LOG_CATEGORIES` (e.g. "net=debug,db*=warn")
+inline bool Category::registerSelf() noexcept {
+  if (const char* env {std::getenv("WARP_LOG_CATEGORIES")}) {
+    static const bool REPORTED {internal::reportBadCategorySpec(env)};
+    (void)REPORTED;
+    internal::applyCategorySpec(env, *this);
+  }
+
+  next = internal::s_core.categories.load(std::memory_order_relaxed);
+  while (!internal::s_core.categories.compare_exchange_weak(
+    next, this, std::memory_order_release, std::memory_order_relaxed
+  )) {}
+  return true;
+}
+
+/// Sets the level of every registered category whose name matches `pattern`
+inline void setCategoryLevel(std::string_view pattern, Level lvl) noexcept {
+  for (Category* it {internal::s_core.categories.load(std::memory_order_acquire)}; it; it = it->next)
+    if (internal::matchPattern(pattern, it->NAME)) it->setLevel(lvl);
+}
+
+} // namespace warp::log
+
+/// Declares a category once at namespace scope : `LOG_CATEGORY(net);` then `Logger {log_category_net, tag}`
+#define LOG_CATEGORY(NAME)                                                \
+  inline constinit warp::log::Category log_category_##NAME {#NAME};       \
+  inline const bool log_category_##NAME##_registered {log_category_##NAME.registerSelf()}
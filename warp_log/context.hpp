@@ -0,0 +1,71 @@
+#pragma once
+
+#include "misc.hpp"
+#include "tag.hpp"
+
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <string_view>
+
+namespace warp::log::internal {
+
+/// Tag rendered once : colored bytes and the same text without ANSI codes
+struct RenderedTag {
+  const std::string COLORED;
+  const std::string PLAIN;
+
+  explicit RenderedTag(Tag tag) : COLORED {std::move(tag)}, PLAIN {stripAnsi(COLORED)} {}
+};
+
+/// Logger prefix made of shared pre-rendered segments
+/// Segments are gathered into the line buffer at write time, `_joined` only backs view()
+class Context {
+public:
+/// Change below constant if needed
+  static constexpr size_t MAX_SEGMENTS = 8;
+
+private:
+  std::array<std::shared_ptr<const RenderedTag>, MAX_SEGMENTS> _segments {};
+  uint8_t                                                      _size     {0};
+  std::string                                                  _joined   {}; // colored segments, for view()
+
+  void _push(Tag tag) {
+    if (tag.empty()) return;
+
+    _joined.append(tag);
+
+    if (_size == MAX_SEGMENTS) { // full : fold the last segment into the new one
+      tag.insert(0, _segments[--_size]->COLORED);
+    }
+    _segments[_size++] = std::make_shared<const RenderedTag>(std::move(tag));
+  }
+
+public:
+  constexpr Context() noexcept = default;
+
+  explicit Context(Tag tag) { _push(std::move(tag)); }
+
+  explicit Context(const std::vector<Tag>& tags) {
+    for (const Tag& TAG : tags) _push(TAG);
+  }
+
+  /// Shares every parent segment and adds `tag` after them
+  [[nodiscard]] Context with(Tag tag) const {
+    Context child {*this};
+    child._push(std::move(tag));
+    return child;
+  }
+
+  [[nodiscard]] bool empty() const noexcept { return _size == 0; }
+
+  [[nodiscard]] std::string_view view() const noexcept { return _joined; }
+
+  void appendTo(std::string& out, bool color) const {
+    for (uint8_t i = 0; i < _size; ++i) out.append(color ? _segments[i]->COLORED : _segments[i]->PLAIN);
+  }
+};
+
+} // namespace warp::log::internal
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string_view>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace warp::log {
+
+struct Category;
+
+} // namespace warp::log
+
+namespace warp::log::internal {
+
+/// --- Terminal utils ---
+
+/// Colors only if `fd` is a terminal, `NO_COLOR` is unset and `TERM` is not "dumb"
+[[nodiscard]] inline bool detectColor(int fd) noexcept {
+  const char* no_color {std::getenv("NO_COLOR")};
+  if (no_color && *no_color) return false;
+
+  const char* term {std::getenv("TERM")};
+  if (term && std::string_view {term} == "dumb") return false;
+
+#ifdef _WIN32
+  return _isatty(fd) != 0;
+#else
+  return isatty(fd) != 0;
+#endif
+}
+
+/// --- Logging core ---
+
+/// Process wide logging state, one instance shared by every translation unit
+/// Constant initialized, so it is usable from any static initializer or destructor
+struct Core {
+  std::mutex             mutex          {};
+  std::atomic<int8_t>    sink_color[2]  {-1, -1};  // [0] std::cout, [1] std::cerr : -1 until detected
+  std::atomic<bool>      show_call_site {false};
+  std::atomic<Category*> categories     {nullptr}; // head of the intrusive category list
+  std::atomic<uint64_t>  lines          {0};
+  std::atomic<uint64_t>  bytes          {0};
+
+  [[nodiscard]] bool sinkColor(bool err) noexcept {
+    int8_t color {sink_color[err].load(std::memory_order_relaxed)};
+    if (color < 0) [[unlikely]] {
+      color = detectColor(err ? 2 : 1);
+      sink_color[err].store(color, std::memory_order_relaxed);
+    }
+    return color;
+  }
+
+  [[nodiscard]] static std::ostream& sinkStream(bool err) noexcept { return err ? std::cerr : std::cout; }
+
+  /// Writes a finished line to a sink
+  void write(bool err, std::string_view line) {
+    std::ostream& os {sinkStream(err)};
+    {
+      std::scoped_lock lock {mutex};
+      os.write(line.data(), static_cast<std::streamsize>(line.size()));
+      os.flush();
+    }
+    lines.fetch_add(1, std::memory_order_relaxed);
+    bytes.fetch_add(line.size(), std::memory_order_relaxed);
+  }
+};
+
+inline constinit Core s_core {};
+
+} // namespace warp::log::internal
+
+namespace warp::log {
+
+struct Stats {
+  uint64_t lines;
+  uint64_t bytes;
+};
+
+/// Lines and bytes written by every logger of the process
+[[nodiscard]] inline Stats getStats() noexcept {
+  return {
+    internal::s_core.lines.load(std::memory_order_relaxed),
+    internal::s_core.bytes.load(std::memory_order_relaxed)
+  };
+}
+
+/// Forces color on or off for std::cout (`err` = false) or std::cerr (`err` = true)
+inline void setSinkColor(bool err, bool enable) noexcept {
+  internal::s_core.sink_color[err].store(enable, std::memory_order_relaxed);
+}
+
+/// Prefixes lines with `file:line` of the call site when enabled
+inline void showCallSite(bool enable) noexcept {
+  internal::s_core.show_call_site.store(enable, std::memory_order_relaxed);
+}
+
+} // namespace warp::log
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <format>
+#include <concepts>
+#include <functional>
+#include <type_traits>
+
+namespace warp::log {
+
+/// Log argument computed only when the line is actually formatted
+/// e.g. `logger.dbg("state: {}", lazy([&] { return dumpState(); }));`
+template <std::invocable F>
+struct Lazy {
+  F fn;
+
+  using Result = std::remove_cvref_t<std::invoke_result_t<const F&>>;
+
+  [[nodiscard]] decltype(auto) operator()() const { return std::invoke(fn); }
+};
+
+template <typename F>
+[[nodiscard]] constexpr Lazy<std::decay_t<F>> lazy(F&& fn) { return {std::forward<F>(fn)}; }
+
+} // namespace warp::log
+
+/// Formats as the callable's result, with the same format spec
+template <typename F, typename CharT>
+struct std::formatter<warp::log::Lazy<F>, CharT> : std::formatter<typename warp::log::Lazy<F>::Result, CharT> {
+  template <typename FormatContext>
+  auto format(const warp::log::Lazy<F>& arg, FormatContext& ctx) const {
+    return std::formatter<typename warp::log::Lazy<F>::Result, CharT>::format(arg(), ctx);
+  }
+};
@@ -2,6 +2,9 @@
 
 #include "misc.hpp"
 #include "tag.hpp"
+#include "category.hpp"
+#include "context.hpp"
+#include "lazy.hpp"
 
 #include <string>
 #include <format>
@@ -14,25 +17,55 @@ namespace warp::log {
 /// Tool to write contextual messages to console
 class Logger {
 protected:
-  std::string _ctx;
+  internal::Context _ctx;
+  const Category*   _category {nullptr};
+
+  /// Filters before any formatting work
+  [[nodiscard]] bool _isOn(Level lvl) const noexcept { return _category == nullptr || _category->isOn(lvl); }
 
   template <typename... Args>
-  void _log(Level lvl, std::format_string<Args...> msg, Args&&... args) const {
+  void _log(Level lvl, const internal::FormatAt<std::type_identity_t<Args>...>& msg, Args&&... args) const {
+    if (!_isOn(lvl)) return;
+
     std::string& fmt_buffer {internal::tl_buf.fmt_buf};
     fmt_buffer.clear();
-    std::format_to(std::back_inserter(fmt_buffer), msg, std::forward<Args>(args)...);
-    internal::writeToConsole(lvl, _ctx, fmt_buffer);
+    std::format_to(std::back_inserter(fmt_buffer), msg.fmt, std::forward<Args>(args)...);
+    _write(lvl, fmt_buffer, internal::touchCallSite(msg.loc));
+  }
+
+  void _write(Level lvl, std::string_view msg, const CallSite* site) const {
+    internal::writeLine(lvl, [this](std::string& out, bool color) { _ctx.appendTo(out, color); }, msg, site);
   }
 
+  explicit Logger(internal::Context ctx, const Category* category) noexcept
+  : _ctx {std::move(ctx)}, _category {category} {}
+
 public:
-  constexpr explicit Logger()                   noexcept = default;
-  constexpr explicit Logger(Tag tag)            noexcept : _ctx {std::move(tag)} {}
-  explicit Logger(const std::vector<Tag>& tags) noexcept : _ctx {std::move(internal::cacheTagVec(tags))} {}
+  constexpr explicit Logger() noexcept = default;
+
+  explicit Logger(Tag tag) noexcept
+  : _ctx {std::move(tag)} {}
+
+  explicit Logger(const std::vector<Tag>& tags) noexcept
+  : _ctx {tags} {}
+
+  explicit Logger(const Category& category, Tag tag) noexcept
+  : _ctx {std::move(tag)}, _category {&category} {}
+
+  explicit Logger(const Category& category, const std::vector<Tag>& tags) noexcept
+  : _ctx {tags}, _category {&category} {}
+
+  /// Logger with `tag` appended to this context, parent segments are shared not copied
+  [[nodiscard]] Logger child(Tag tag) const { return Logger {_ctx.with(std::move(tag)), _category}; }
 
 #define LOG_FN_IMPL(FN, LVL) \
   template <typename... Args> \
-  void FN(std::format_string<Args...> msg, Args&&... args) const { _log(LVL, msg, std::forward<Args>(args)...); } \
-  void FN(std::string_view msg) const { internal::writeToConsole(LVL, _ctx, msg); }
+  void FN(internal::FormatAt<std::type_identity_t<Args>...> msg, Args&&... args) const { \
+    _log<Args...>(LVL, msg, std::forward<Args>(args)...);                                  \
+  }                                                                                        \
+  void FN(internal::MessageAt msg) const {                                                 \
+    if (_isOn(LVL)) _write(LVL, msg.msg, internal::touchCallSite(msg.loc));                \
+  }
 
   LOG_FN_IMPL(msg , Level::Message)
   LOG_FN_IMPL(info, Level::Info)
@@ -47,7 +80,7 @@ public:
   LOG_FN_IMPL(dbg, Level::Debug)
 #endif
 
-  [[nodiscard]] constexpr std::string_view getContext() const noexcept { return _ctx; }
+  [[nodiscard]] std::string_view getContext() const noexcept { return _ctx.view(); }
 
 #undef LOG_FN_IMPL
 };
@@ -1,7 +1,12 @@
 #pragma once
 
+#include "core.hpp"
+#include "call_site.hpp"
+#include "scoped_context.hpp"
+
 #include <mutex>
 #include <format>
+#include <charconv>
 #include <string>
 #include <cstdint>
 #include <iostream>
@@ -32,9 +37,59 @@ enum class ANSIFore : uint8_t {
   LightWhite
 };
 
+} // namespace warp::log
+
+namespace warp::log::internal {
+
+/// --- Terminal utils ---
+
+[[nodiscard]] inline bool streamColor(const std::ostream& os) noexcept {
+  if (&os == &std::cout)                      return s_core.sinkColor(false);
+  if (&os == &std::cerr || &os == &std::clog) return s_core.sinkColor(true);
+  return true;
+}
+
+/// Appends `text` without its ANSI escape sequences
+inline constexpr void appendStripped(std::string& out, std::string_view text) {
+  size_t i {0};
+
+  while (i < text.size()) {
+    const size_t ESC {text.find('\033', i)};
+    out.append(text.substr(i, ESC - i));
+    if (ESC == std::string_view::npos) return;
+
+    i = ESC + 1;
+    if (i < text.size() && text[i] == '[') {
+      ++i;
+      while (i < text.size() && (text[i] < 0x40 || text[i] > 0x7E)) ++i; // parameter bytes
+      ++i;                                                               // final byte
+    }
+  }
+}
+
+/// Most text holds no escape at all : copied as is after one scan
+inline constexpr void appendPlain(std::string& out, std::string_view text) {
+  if (text.find('\033') == std::string_view::npos) out.append(text);
+  else                                               appendStripped(out, text);
+}
+
+[[nodiscard]] inline constexpr std::string stripAnsi(std::string_view text) {
+  std::string out;
+  out.reserve(text.size());
+  appendStripped(out, text);
+  return out;
+}
+
+} // namespace warp::log::internal
+
+namespace warp::log {
+
 /// --- Console logging utils ---
 
-inline std::ostream& operator<<(std::ostream& os, ANSIFore fg) noexcept { return os << "\033[" << static_cast<int>(fg) << 'm'; }
+inline std::ostream& operator<<(std::ostream& os, ANSIFore fg) noexcept {
+  if (!internal::streamColor(os)) return os;
+  return os << "\033[" << static_cast<int>(fg) << 'm';
+}
 
 [[nodiscard]] inline std::string setColor(ANSIFore fg) noexcept { return std::format("\033[{}m", static_cast<int>(fg)); }
 [[nodiscard]] inline constexpr const char* resetColor() noexcept { return "\033[0m"; }
@@ -67,10 +122,26 @@ namespace warp::log::internal {
   }
 }
 
-[[nodiscard]] inline std::ostream& streamFromLevel(Level lvl) noexcept {
-  return (lvl == Level::Info || lvl == Level::Debug) ? std::cout : std::cerr;
+/// Ordering used for filtering : Debug < Info = Message < Warn < Error
+[[nodiscard]] inline constexpr uint8_t levelSeverity(Level lvl) noexcept {
+  switch (lvl) {
+    case Level::Debug: return 0;
+    case Level::Warn:  return 2;
+    case Level::Error: return 3;
+    default:           return 1;
+  }
 }
 
+/// Pre-rendered level tags : [color][level]
+inline constexpr std::string_view LEVEL_TAG[2][5] {
+  {"", "[INFO]", "[DEBUG]", "[WARN]", "[ERROR]"},
+  {"", "\033[32m[INFO]\033[0m", "\033[36m[DEBUG]\033[0m", "\033[33m[WARN]\033[0m", "\033[31m[ERROR]\033[0m"},
+};
+
+[[nodiscard]] inline constexpr bool isErrorSink(Level lvl) noexcept { return !(lvl == Level::Info || lvl == Level::Debug); }
+
+[[nodiscard]] inline std::ostream& streamFromLevel(Level lvl) noexcept { return Core::sinkStream(isErrorSink(lvl)); }
+
 /// Pre-allocated string buffer for performance boost
 struct ThreadLocalBuffer {
   std::string log_buf;
@@ -86,34 +157,63 @@ struct ThreadLocalBuffer {
   }
 };
 
-static std::mutex s_console_mutex {};
 inline thread_local ThreadLocalBuffer tl_buf {};
 
 /// Logs to console with added level prefix
-inline void writeToConsole(Level lvl, std::string_view pre, std::string_view msg) {
+/// `append_prefix(buf, color)` gathers the caller's prefix pieces straight into the line buffer
+template <typename AppendPrefix>
+inline void writeLine(Level lvl, AppendPrefix&& append_prefix, std::string_view msg, const CallSite* site = nullptr) {
   std::string& log_buf = tl_buf.log_buf; // uses pre allocated buffer for performance
   log_buf.clear();
-  log_buf.append(pre);
+
+  const bool ERR   {isErrorSink(lvl)};
+  const bool COLOR {s_core.sinkColor(ERR)};
+  append_prefix(log_buf, COLOR);
+  log_buf.append(tl_context.rendered());
 
   const bool HAS_LEVEL = lvl != Level::Message;
 
   if (HAS_LEVEL) {
-    if (!pre.empty()) log_buf.append(" : ");
+    if (!log_buf.empty()) log_buf.append(" : ");
+    log_buf.append(LEVEL_TAG[COLOR][static_cast<uint8_t>(lvl)]);
+  }
+
+  if (site && s_core.show_call_site.load(std::memory_order_relaxed)) {
+    if (!log_buf.empty()) log_buf.append(" : ");
 
-    log_buf
-      .append(setColor(levelToColor(lvl)))
-      .append(levelToString(lvl))
-      .append(resetColor());
+    char line_buf[16];
+    const auto [END, _] {std::to_chars(line_buf, line_buf + sizeof(line_buf), site->line)};
+    log_buf.append(site->file).append(":").append(line_buf, END);
   }
 
   if (HAS_LEVEL || !log_buf.empty()) log_buf.append(" : ");
 
-  log_buf.append(msg).push_back('\n');
+  if (COLOR) log_buf.append(msg);
+  else       appendPlain(log_buf, msg);
+  log_buf.push_back('\n');
+
+  s_core.write(ERR, log_buf);
+}
+
+/// `pre_plain` is written instead of `pre` to sinks without color support, it must hold no escapes
+inline void writeToConsole(
+  Level lvl,
+  std::string_view pre,
+  std::string_view pre_plain,
+  std::string_view msg,
+  const CallSite* site = nullptr
+) {
+  writeLine(lvl, [&](std::string& out, bool color) {
+    if (color) out.append(pre);
+    else       out.append(pre_plain);
+  }, msg, site);
+}
 
-  std::ostream& os {streamFromLevel(lvl)};
-  std::scoped_lock lock {s_console_mutex};
-  os.write(log_buf.data(), static_cast<std::streamsize>(log_buf.size()));
-  os.flush();
+inline void writeToConsole(Level lvl, std::string_view pre, std::string_view msg, const CallSite* site = nullptr) {
+  writeLine(lvl, [&](std::string& out, bool color) {
+    if (color) out.append(pre);
+    else       appendPlain(out, pre);
+  }, msg, site);
 }
 
 } // namespace warp::log::internal
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <format>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <string_view>
+
+namespace warp::log::internal {
+
+/// --- Diagnostic context storage ---
+
+/// One `[key=value]` entry, offsets into ContextStack::bytes
+struct ContextFrame {
+  uint16_t begin;
+  uint16_t key_len;
+  uint16_t end;
+};
+
+/// Fixed size per thread stack of rendered context entries, never allocates
+struct ContextStack {
+/// Change below constants if needed
+  static constexpr size_t CAPACITY  = 512;
+  static constexpr size_t MAX_DEPTH = 16;
+
+  char         bytes[CAPACITY]   {};
+  ContextFrame frames[MAX_DEPTH] {};
+  uint16_t     size  {0};
+  uint8_t      depth {0};
+
+  [[nodiscard]] std::string_view rendered() const noexcept { return {bytes, size}; }
+
+  /// Renders `[key=value]` at the top, returns false when out of room
+  template <typename T>
+  bool push(std::string_view key, const T& value) {
+    if (depth == MAX_DEPTH) return false;
+
+    const size_t ROOM {CAPACITY - size};
+    if (ROOM < key.size() + sizeof("[=]")) return false;
+
+    char* out {bytes + size};
+    *out++ = '[';
+    std::memcpy(out, key.data(), key.size());
+    out += key.size();
+    *out++ = '=';
+
+    const size_t VALUE_ROOM {static_cast<size_t>(bytes + CAPACITY - out) - 1}; // keeps one byte for ']'
+    const auto RESULT {std::format_to_n(out, static_cast<std::ptrdiff_t>(VALUE_ROOM), "{}", value)};
+    if (static_cast<size_t>(RESULT.size) > VALUE_ROOM) return false;
+
+    out = RESULT.out;
+    *out++ = ']';
+
+    frames[depth++] = {size, static_cast<uint16_t>(key.size()), static_cast<uint16_t>(out - bytes)};
+    size = static_cast<uint16_t>(out - bytes);
+    return true;
+  }
+
+  /// Appends pre-rendered frames, e.g. from a snapshot taken on another thread
+  bool pushFrames(const char* src, const ContextFrame* src_frames, uint8_t count) {
+    if (count == 0) return true;
+
+    const uint16_t BEGIN {src_frames[0].begin};
+    const uint16_t LEN   {static_cast<uint16_t>(src_frames[count - 1].end - BEGIN)};
+    if (depth + count > MAX_DEPTH || size + LEN > CAPACITY) return false;
+
+    std::memcpy(bytes + size, src + BEGIN, LEN);
+    for (uint8_t i = 0; i < count; ++i) {
+      const ContextFrame& FRAME {src_frames[i]};
+      frames[depth++] = {
+        static_cast<uint16_t>(FRAME.begin - BEGIN + size),
+        FRAME.key_len,
+        static_cast<uint16_t>(FRAME.end - BEGIN + size)
+      };
+    }
+    size = static_cast<uint16_t>(size + LEN);
+    return true;
+  }
+
+  void popTo(uint8_t to_depth, uint16_t to_size) noexcept {
+    depth = to_depth;
+    size  = to_size;
+  }
+
+  /// Calls `fn(key, value)` for each entry, outermost first
+  template <typename Fn>
+  void forEachField(Fn&& fn) const {
+    for (uint8_t i = 0; i < depth; ++i) {
+      const ContextFrame& FRAME {frames[i]};
+      const char* key {bytes + FRAME.begin + 1};
+      fn(
+        std::string_view {key, FRAME.key_len},
+        std::string_view {key + FRAME.key_len + 1, static_cast<size_t>(FRAME.end - FRAME.begin - FRAME.key_len - 3)}
+      );
+    }
+  }
+};
+
+inline thread_local ContextStack tl_context {};
+
+} // namespace warp::log::internal
+
+namespace warp::log {
+
+/// Copy of a thread's diagnostic context, to carry it over to deferred work or other threads
+using ContextSnapshot = internal::ContextStack;
+
+/// Copied by value, e.g. `ContextSnapshot snap {currentContext()};` then `ScopedContext ctx {snap};` on the worker
+[[nodiscard]] inline const ContextSnapshot& currentContext() noexcept { return internal::tl_context; }
+
+/// Calls `fn(key, value)` for each entry of this thread's diagnostic context
+template <typename Fn>
+void forEachContextField(Fn&& fn) { internal::tl_context.forEachField(std::forward<Fn>(fn)); }
+
+/// Adds `[key=value]` to every line logged by this thread until the end of the scope
+/// Entries that do not fit in ContextStack are dropped
+class ScopedContext {
+private:
+  const uint8_t  _DEPTH;
+  const uint16_t _SIZE;
+
+public:
+  template <typename T>
+  explicit ScopedContext(std::string_view key, const T& value)
+  : _DEPTH {internal::tl_context.depth}, _SIZE {internal::tl_context.size} {
+    if (!internal::tl_context.push(key, value)) internal::tl_context.popTo(_DEPTH, _SIZE);
+  }
+
+  /// Restores the entries of `snapshot` on this thread
+  explicit ScopedContext(const ContextSnapshot& snapshot)
+  : _DEPTH {internal::tl_context.depth}, _SIZE {internal::tl_context.size} {
+    internal::tl_context.pushFrames(snapshot.bytes, snapshot.frames, snapshot.depth);
+  }
+
+  ~ScopedContext() noexcept { internal::tl_context.popTo(_DEPTH, _SIZE); }
+
+  ScopedContext(const ScopedContext&)            = delete;
+  ScopedContext& operator=(const ScopedContext&) = delete;
+};
+
+} // namespace warp::log
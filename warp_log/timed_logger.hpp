@@ -11,14 +11,15 @@ namespace warp::log {
 /// Tools to add context and timestamp to console messages
 class TimedLogger final : public Logger {
 private:
-  mutable std::string                           _cached_timestamp {""};
-  mutable std::chrono::system_clock::time_point _last_update      {
+  mutable std::string                           _cached_timestamp       {""};
+  mutable std::string                           _cached_timestamp_plain {""};
+  mutable std::chrono::system_clock::time_point _last_update            {
     std::chrono::system_clock::time_point::min()
   };
 
   static constexpr std::chrono::seconds TIMESTAMP_CACHE_DURATION {1};
 
-  [[nodiscard]] std::string _getTimestampTag() const noexcept {
+  void _updateTimestamp() const noexcept {
     auto now = std::chrono::system_clock::now();
 
     if (now - _last_update > TIMESTAMP_CACHE_DURATION || _cached_timestamp.empty()) {
@@ -31,27 +32,36 @@ private:
       localtime_r(&t, &tm_struct);
 #endif
       std::strftime(buf, sizeof(buf), "[%H:%M:%S]", &tm_struct);
-      _cached_timestamp = makeColoredTag(timestamp_color, buf);
+      _cached_timestamp       = makeColoredTag(timestamp_color, buf);
+      _cached_timestamp_plain = buf;
       _last_update = now;
     }
+  }
 
-    return _cached_timestamp;
+  void _write(Level lvl, std::string_view msg, const CallSite* site) const {
+    _updateTimestamp();
+    internal::writeLine(lvl, [this](std::string& out, bool color) {
+      out.append(color ? _cached_timestamp : _cached_timestamp_plain);
+      _ctx.appendTo(out, color);
+    }, msg, site);
   }
 
   template <typename... Args>
-  void _log(Level lvl, std::format_string<Args...> msg, Args&&... args) const {
+  void _log(Level lvl, const internal::FormatAt<std::type_identity_t<Args>...>& msg, Args&&... args) const {
+    if (!_isOn(lvl)) return;
+
     std::string& format_buffer {internal::tl_buf.fmt_buf};
     format_buffer.clear();
-    std::format_to(std::back_inserter(format_buffer), msg, std::forward<Args>(args)...);
-    internal::writeToConsole(lvl, _getTimestampTag() + _ctx, format_buffer);
+    std::format_to(std::back_inserter(format_buffer), msg.fmt, std::forward<Args>(args)...);
+    _write(lvl, format_buffer, internal::touchCallSite(msg.loc));
   }
 
 public:
   ANSIFore timestamp_color {ANSIFore::White};
 
-  constexpr explicit TimedLogger() noexcept = default;
+  explicit TimedLogger() noexcept = default;
 
-  constexpr explicit TimedLogger(Tag tag, ANSIFore timestamp_color = ANSIFore::White) noexcept
+  explicit TimedLogger(Tag tag, ANSIFore timestamp_color = ANSIFore::White) noexcept
   : Logger          {std::move(tag)}
   , timestamp_color {timestamp_color} {}
 
@@ -59,13 +69,35 @@ public:
     const std::vector<Tag>& tags,
     ANSIFore timestamp_color = ANSIFore::White
   ) noexcept
-  : Logger          {std::move(internal::cacheTagVec(tags))}
+  : Logger          {tags}
+  , timestamp_color {timestamp_color} {}
+
+  explicit TimedLogger(
+    const Category& category,
+    Tag tag,
+    ANSIFore timestamp_color = ANSIFore::White
+  ) noexcept
+  : Logger          {category, std::move(tag)}
   , timestamp_color {timestamp_color} {}
 
+  /// TimedLogger with `tag` appended to this context, parent segments are shared not copied
+  [[nodiscard]] TimedLogger child(Tag tag) const {
+    TimedLogger out;
+    out._ctx            = _ctx.with(std::move(tag));
+    out._category       = _category;
+    out.timestamp_color = timestamp_color;
+    return out;
+  }
+
 #define LOG_FN_IMPL(FN, LVL)  \
   template <typename... Args> \
-  void FN(std::format_string<Args...> msg, Args&&... args) const { _log(LVL, msg, std::forward<Args>(args)...); } \
-  void FN(std::string_view msg) const { internal::writeToConsole(LVL, _getTimestampTag() + _ctx, msg); }
+  void FN(internal::FormatAt<std::type_identity_t<Args>...> msg, Args&&... args) const {      \
+    _log<Args...>(LVL, msg, std::forward<Args>(args)...);                                      \
+  }                                                                                            \
+  void FN(internal::MessageAt msg) const {                                                     \
+    if (!_isOn(LVL)) return;                                                                   \
+    _write(LVL, msg.msg, internal::touchCallSite(msg.loc));                                    \
+  }
 
   LOG_FN_IMPL(msg, Level::Message)
   LOG_FN_IMPL(info, Level::Info)
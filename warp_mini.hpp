@@ -11,6 +11,9 @@
 #define ENABLE_TIMESTAMP        1
 #define ENABLE_COLOR_CODE       1
 
+#define ENABLE_CALL_SITE        1   // static descriptor per WLOG use site : id, location and hit counter
+#define ENABLE_CALL_SITE_PREFIX 0   // adds [file:line] to the line prefix, needs ENABLE_CALL_SITE
+
 #define TEST_PASS_TEXT          "[PASS]"
 #define TEST_FAIL_TEXT          "[FAIL]"
 
@@ -18,16 +21,57 @@
 #define SCOPE_ENTER_TEXT        "--{"
 #define SCOPE_LEAVE_TEXT        "}--"
 
+#define TRACE_TIMING_MODE       0   // 0 : off, 1 : elapsed time on leave, 2 : summary table at exit
+#define TRACE_MAX_DEPTH         256
+
+#define ENABLE_TRACE_INDENT     1
+#define TRACE_INDENT_TEXT       "  "
+#define ENABLE_TRACE_THREAD_ID  1
+#define TRACE_PER_THREAD_FILE   0   // 1 : trace lines go to "warp_trace_[<name>_]<thread>.log" instead of the console
+
 /// --- Includes ---
 
 #include <cstdint>
+#include <cstddef>
+#include <cstdlib>
+#include <cstdio>
+#include <format>
+#include <string>
+#include <string_view>
 #include <iostream>
 #include <mutex>
+#include <atomic>
+#include <iterator>
+#include <charconv>
+#include <concepts>
+#include <sstream>
+#include <iomanip>
+#include <memory>
+#include <type_traits>
+#include <functional>
+
+#if ENABLE_CALL_SITE
+#include <source_location>
+#endif
 
-#if ENABLE_TIMESTAMP
+#if ENABLE_COLOR_CODE
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+#endif
+
+#if ENABLE_TIMESTAMP || TRACE_TIMING_MODE
 #include <chrono>
 #endif
 
+#if TRACE_TIMING_MODE == 2
+#include <vector>
+#include <algorithm>
+#include <unordered_map>
+#endif
+
 /// --- Utilities ---
 
 /// Supported log levels
@@ -62,24 +106,334 @@ static constexpr const char* COLOR_TABLE[] {
 };
 #endif
 
+#ifdef NDEBUG
+static constexpr LogLevel MIN_LOG_LEVEL = MIN_LOG_LVL_RELEASE;
+#else
+static constexpr LogLevel MIN_LOG_LEVEL = MIN_LOG_LVL_DEBUG;
+#endif
+
+/// --- Logging core ---
+
+struct LogCategory;
+struct CallSite;
+
+/// Colors only if `fd` is a terminal, `NO_COLOR` is unset and `TERM` is not "dumb"
+[[nodiscard]] inline bool detectColor([[maybe_unused]] int fd) noexcept {
 #if ENABLE_COLOR_CODE
-static constexpr const char* PASS {"\033[32m" TEST_PASS_TEXT "\033[0m"};
-static constexpr const char* FAIL {"\033[31m" TEST_FAIL_TEXT "\033[0m"};
+  const char* no_color {std::getenv("NO_COLOR")};
+  if (no_color && *no_color) return false;
+
+  const char* term {std::getenv("TERM")};
+  if (term && std::string_view {term} == "dumb") return false;
+
+#ifdef _WIN32
+  return _isatty(fd) != 0;
+#else
+  return isatty(fd) != 0;
+#endif
 #else
-static constexpr const char* PASS {TEST_PASS_TEXT};
-static constexpr const char* FAIL {TEST_FAIL_TEXT};
+  return false;
 #endif
+}
 
-#ifdef NDEBUG
-static constexpr LogLevel MIN_LOG_LEVEL = MIN_LOG_LVL_RELEASE;
+/// Process wide logging state, one instance shared by every translation unit
+/// Constant initialized, so it is usable from any static initializer or destructor
+struct LogCore {
+  std::mutex                mutex          {};
+  std::atomic<uint8_t>      level          {MIN_LOG_LEVEL}; // runtime level, above the compile time floor
+  std::atomic<int8_t>       sink_color[2]  {-1, -1};        // [0] std::cout, [1] std::cerr : -1 until detected
+  std::atomic<LogCategory*> categories     {nullptr};
+  std::atomic<CallSite*>    call_sites     {nullptr};
+  std::atomic<uint32_t>     next_call_site {0};
+  std::atomic<uint32_t>     next_thread    {0};
+  std::atomic<uint64_t>     lines          {0};
+  std::atomic<uint64_t>     bytes          {0};
+
+  [[nodiscard]] bool sinkColor(bool err) noexcept {
+    int8_t color {sink_color[err].load(std::memory_order_relaxed)};
+    if (color < 0) [[unlikely]] {
+      color = detectColor(err ? 2 : 1);
+      sink_color[err].store(color, std::memory_order_relaxed);
+    }
+    return color;
+  }
+
+  /// Writes a finished line to the sink of its level
+  void write(LogLevel lvl, std::string_view line) {
+    std::ostream& os {(lvl < L_WARN) ? std::cout : std::cerr};
+    {
+      std::scoped_lock lock {mutex};
+      os.write(line.data(), static_cast<std::streamsize>(line.size()));
+    }
+    lines.fetch_add(1, std::memory_order_relaxed);
+    bytes.fetch_add(line.size(), std::memory_order_relaxed);
+  }
+};
+
+inline constinit LogCore s_core {};
+
+struct LogStats {
+  uint64_t lines;
+  uint64_t bytes;
+};
+
+[[nodiscard]] inline LogStats getLogStats() noexcept {
+  return {s_core.lines.load(std::memory_order_relaxed), s_core.bytes.load(std::memory_order_relaxed)};
+}
+
+/// Forces color on or off for std::cout (`err` = false) or std::cerr (`err` = true)
+inline void setSinkColor(bool err, bool enable) noexcept {
+  s_core.sink_color[err].store(enable, std::memory_order_relaxed);
+}
+
+/// --- Runtime log level ---
+// Second filter stage : levels below MIN_LOG_LEVEL are already compiled out
+
+/// Parses "trace", "debug", "info", "warn", "error", "fatal" or "0" - "5"
+[[nodiscard]] inline bool parseLogLevel(std::string_view text, LogLevel& out) noexcept {
+  static constexpr std::string_view NAMES[] {"trace", "debug", "info", "warn", "error", "fatal"};
+
+  if (text.size() == 1 && text[0] >= '0' && text[0] <= '5') {
+    out = static_cast<LogLevel>(text[0] - '0');
+    return true;
+  }
+
+  for (uint8_t i = 0; i < std::size(NAMES); ++i) {
+    if (text.size() != NAMES[i].size()) continue;
+
+    bool equal {true};
+    for (size_t c = 0; c < text.size() && equal; ++c) equal = (text[c] | 0x20) == NAMES[i][c];
+
+    if (equal) {
+      out = static_cast<LogLevel>(i);
+      return true;
+    }
+  }
+
+  return false;
+}
+
+inline void setLogLevel(LogLevel level) noexcept { s_core.level.store(level, std::memory_order_relaxed); }
+
+[[nodiscard]] inline LogLevel getLogLevel() noexcept {
+  return static_cast<LogLevel>(s_core.level.load(std::memory_order_relaxed));
+}
+
+[[nodiscard]] inline bool isLogLevelOn(LogLevel level) noexcept {
+  return level >= s_core.level.load(std::memory_order_relaxed);
+}
+
+/// Applies `WARP_LOG_LEVEL` from the environment, if set and valid
+inline bool applyEnvLogLevel() noexcept {
+  LogLevel level {};
+  const char* env {std::getenv("WARP_LOG_LEVEL")};
+  if (env == nullptr || !parseLogLevel(env, level)) return false;
+
+  setLogLevel(level);
+  return true;
+}
+
+inline const bool s_env_log_level_applied {applyEnvLogLevel()};
+
+/// --- Log categories ---
+
+/// Glob match supporting `*` and `?`
+[[nodiscard]] inline bool matchPattern(std::string_view pattern, std::string_view text) noexcept {
+  size_t p {0}, t {0}, star {std::string_view::npos}, retry {0};
+
+  while (t < text.size()) {
+    if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == text[t])) { ++p; ++t; }
+    else if (p < pattern.size() && pattern[p] == '*')                       { star = p++; retry = t; }
+    else if (star != std::string_view::npos)                                 { p = star + 1; t = ++retry; }
+    else return false;
+  }
+
+  while (p < pattern.size() && pattern[p] == '*') ++p;
+  return p == pattern.size();
+}
+
+/// Per module log level, declared once with `WLOG_CATEGORY(name)`
+/// Own cache line so that checks never share it with other writes
+struct alignas(64) LogCategory {
+  static constexpr uint8_t INHERIT {0xFF}; // follow the global runtime level
+
+  std::atomic<uint8_t> level {INHERIT};
+  const char*          NAME;
+  LogCategory*         next  {nullptr};
+
+  constexpr explicit LogCategory(const char* name) noexcept : NAME {name} {}
+
+  [[nodiscard]] bool isOn(LogLevel lvl) const noexcept {
+    const uint8_t LEVEL {level.load(std::memory_order_relaxed)};
+    return (LEVEL == INHERIT) ? isLogLevelOn(lvl) : lvl >= LEVEL;
+  }
+
+  bool registerSelf() noexcept;
+};
+
+/// Calls `fn(entry, pattern, level_text)` for every non empty entry of a comma separated spec
+template <typename Fn>
+inline void forEachSpecEntry(std::string_view spec, Fn&& fn) noexcept {
+  while (!spec.empty()) {
+    const size_t COMMA {spec.find(',')};
+    const std::string_view ENTRY {spec.substr(0, COMMA)};
+    spec = (COMMA == std::string_view::npos) ? std::string_view {} : spec.substr(COMMA + 1);
+    if (ENTRY.empty()) continue;
+
+    const size_t EQ {ENTRY.find('=')};
+    fn(ENTRY, EQ == std::string_view::npos ? ENTRY : ENTRY.substr(0, EQ), EQ == std::string_view::npos ? std::string_view {} : ENTRY.substr(EQ + 1));
+  }
+}
+
+/// Applies every `pattern=level` entry of a comma separated spec that matches `category`
+inline void applyCategorySpec(std::string_view spec, LogCategory& category) noexcept {
+  forEachSpecEntry(spec, [&category](std::string_view, std::string_view pattern, std::string_view level) {
+    LogLevel lvl {};
+    if (matchPattern(pattern, category.NAME) && parseLogLevel(level, lvl)) category.level.store(lvl, std::memory_order_relaxed);
+  });
+}
+
+/// Reports entries without `=` or with an unknown level on stderr, once per process
+inline bool reportBadCategorySpec(std::string_view spec) noexcept {
+  forEachSpecEntry(spec, [](std::string_view entry, std::string_view, std::string_view level) {
+    LogLevel lvl {};
+    if (!parseLogLevel(level, lvl))
+      std::fprintf(stderr, "[WARP_LOG_CATEGORIES] ignoring \"%.*s\" : expected pattern=trace|debug|info|warn|error|fatal|0-5\n", static_cast<int>(entry.size()), entry.data());
+  });
+  return true;
+}
+
+/// Links the category into the registry and applies `WARP_LOG_CATEGORIES` (e.g. "net=debug,db*=warn")
+inline bool LogCategory::registerSelf() noexcept {
+  if (const char* env {std::getenv("WARP_LOG_CATEGORIES")}) {
+    static const bool REPORTED {reportBadCategorySpec(env)};
+    (void)REPORTED;
+    applyCategorySpec(env, *this);
+  }
+
+  next = s_core.categories.load(std::memory_order_relaxed);
+  while (!s_core.categories.compare_exchange_weak(next, this, std::memory_order_release, std::memory_order_relaxed)) {}
+  return true;
+}
+
+/// Sets the level of every registered category whose name matches `pattern`
+inline void setCategoryLevel(std::string_view pattern, LogLevel lvl) noexcept {
+  for (LogCategory* it {s_core.categories.load(std::memory_order_acquire)}; it; it = it->next)
+    if (matchPattern(pattern, it->NAME)) it->level.store(lvl, std::memory_order_relaxed);
+}
+
+/// Makes every category matching `pattern` follow the global runtime level again
+inline void resetCategoryLevel(std::string_view pattern) noexcept {
+  for (LogCategory* it {s_core.categories.load(std::memory_order_acquire)}; it; it = it->next)
+    if (matchPattern(pattern, it->NAME)) it->level.store(LogCategory::INHERIT, std::memory_order_relaxed);
+}
+
+/// --- Call sites ---
+
+#if ENABLE_CALL_SITE
+
+/// Static descriptor of a WLOG use site, created on its first line
+struct CallSite {
+  const char*           FILE_NAME;
+  const char*           FUNCTION_NAME;
+  const uint32_t        LINE;
+  const uint32_t        ID;   // dense, stable for the process : usable instead of the strings
+  std::atomic<uint64_t> hits {0};
+  CallSite*             next {nullptr};
+
+  explicit CallSite(const std::source_location& loc) noexcept
+  : FILE_NAME     {loc.file_name()}
+  , FUNCTION_NAME {loc.function_name()}
+  , LINE          {loc.line()}
+  , ID            {s_core.next_call_site.fetch_add(1, std::memory_order_relaxed)} {
+    for (const char* it {FILE_NAME}; *it; ++it) if (*it == '/' || *it == '\\') FILE_NAME = it + 1;
+
+    next = s_core.call_sites.load(std::memory_order_relaxed);
+    while (!s_core.call_sites.compare_exchange_weak(next, this, std::memory_order_release, std::memory_order_relaxed)) {}
+  }
+
+  /// Counts the emitted line
+  const CallSite& touch() noexcept {
+    hits.fetch_add(1, std::memory_order_relaxed);
+    return *this;
+  }
+
+  friend std::ostream& operator<<(std::ostream& os, [[maybe_unused]] const CallSite& site) {
+#if ENABLE_CALL_SITE_PREFIX
+    return os << '[' << site.FILE_NAME << ':' << site.LINE << ']';
 #else
-static constexpr LogLevel MIN_LOG_LEVEL = MIN_LOG_LVL_DEBUG;
+    return os;
+#endif
+  }
+};
+
+/// `Unique` is a lambda type from the use site, so every site owns its static descriptor
+template <typename Unique>
+[[nodiscard]] inline CallSite& internCallSite(Unique, const std::source_location& loc) noexcept {
+  static CallSite s_site {loc};
+  return s_site;
+}
+
+/// Visits every call site that has logged, e.g. to write the id table of a binary log
+template <typename Fn>
+inline void forEachCallSite(Fn&& fn) {
+  for (const CallSite* it {s_core.call_sites.load(std::memory_order_acquire)}; it; it = it->next) fn(*it);
+}
+
+#define WLOG_CALL_SITE_IMPL \
+  << warp::mini::internCallSite([] {}, std::source_location::current()).touch()
+
+/// Site of the macro expansion, handed to helpers that log on the caller's behalf
+#define WLOG_SITE_HERE \
+  (&warp::mini::internCallSite([] {}, std::source_location::current()))
+
+#else
+
+struct CallSite {};
+
+#define WLOG_CALL_SITE_IMPL
+#define WLOG_SITE_HERE  static_cast<warp::mini::CallSite*>(nullptr)
+
 #endif
 
+/// --- Terminal capabilities ---
+
+[[nodiscard]] inline bool sinkColor(LogLevel level) noexcept { return s_core.sinkColor(level >= L_WARN); }
+
+[[nodiscard]] inline bool streamColor(const std::ostream& os) noexcept {
+  if (&os == &std::cout)                      return s_core.sinkColor(false);
+  if (&os == &std::cerr || &os == &std::clog) return s_core.sinkColor(true);
+  return ENABLE_COLOR_CODE;
+}
+
+/// ANSI code, written only to streams that support it
+struct Ansi {
+  const char* CODE;
+
+  friend std::ostream& operator<<(std::ostream& os, Ansi ansi) {
+    if (streamColor(os)) os << ansi.CODE;
+    return os;
+  }
+};
+
+/// Text wrapped in an ANSI color when the stream supports it
+struct ColorText {
+  int         COLOR_CODE;
+  const char* TEXT;
+
+  friend std::ostream& operator<<(std::ostream& os, ColorText text) {
+    if (streamColor(os)) return os << "\033[" << text.COLOR_CODE << 'm' << text.TEXT << "\033[0m";
+    return os << text.TEXT;
+  }
+};
+
+static constexpr ColorText PASS {32, TEST_PASS_TEXT};
+static constexpr ColorText FAIL {31, TEST_FAIL_TEXT};
+
 /// Automatically resets terminal at the end of program
 struct ResetTerminal {
   static void reset() noexcept {
-    std::cout << "\033[0m" << std::endl;
+    std::cout << Ansi {"\033[0m"} << std::endl;
   }
 
   ~ResetTerminal() noexcept {
@@ -89,34 +443,25 @@ struct ResetTerminal {
 
 static ResetTerminal s_reset_term {};
 
-inline std::ostream& logStream(LogLevel level) {
-  static std::mutex s_log_mutex {};
-  std::scoped_lock lock {s_log_mutex};
-  return (level < L_WARN) ? std::cout : std::cerr;
-}
-
-[[nodiscard]] static constexpr inline std::string_view openColor(LogLevel level) noexcept {
+[[nodiscard]] static constexpr inline Ansi openColor(LogLevel level) noexcept {
 #if ENABLE_COLOR_CODE
-  return COLOR_TABLE[level];
+  return {COLOR_TABLE[level]};
 #else
-  return "";
+  static_cast<void>(level);
+  return {""};
 #endif
 }
 
-[[nodiscard]] static constexpr inline const char* closeColor() noexcept {
+[[nodiscard]] static constexpr inline Ansi closeColor() noexcept {
 #if ENABLE_COLOR_CODE
-  return "\033[0m : ";
+  return {"\033[0m"};
 #else
-  return " : ";
+  return {""};
 #endif
 }
 
-[[nodiscard]] static inline std::string colorText(int color_code, const char* text) noexcept {
-#if ENABLE_COLOR_CODE
-  return std::format("\033[{}m{}\033[0m", color_code, text);
-#else
-  return text;
-#endif
+[[nodiscard]] static constexpr inline ColorText colorText(int color_code, const char* text) noexcept {
+  return {color_code, text};
 }
 
 [[nodiscard]] static inline std::string_view getTimestamp() noexcept {
@@ -141,7 +486,281 @@ inline std::ostream& logStream(LogLevel level) {
 
 [[noreturn]] static inline void killProcess() noexcept { std::abort(); }
 
-/// [PASS], [FAIL]
+/// --- Line builder ---
+
+template <typename T>
+concept Formattable = requires { std::formatter<std::remove_cvref_t<T>, char> {}; };
+
+template <typename T>
+concept Streamable = requires (std::ostream& os, const T& val) { os << val; };
+
+/// Hides std::ostream's member operator<<, so integer promotion cannot pick them
+struct MemberlessStream : std::ostream {
+  void operator<<(const MemberlessStream&) = delete;
+};
+
+/// Enums with their own non member operator<<, unscoped ones are Streamable through int anyway
+template <typename T>
+concept OwnStreamable = requires (MemberlessStream& os, const T& val) { os << val; };
+
+template <typename T>
+concept CharType = std::same_as<T, char> || std::same_as<T, signed char> || std::same_as<T, unsigned char>;
+
+/// Parameterized manipulators from <iomanip> that only change the stream state
+template <typename T>
+concept StateManip =
+  std::same_as<T, decltype(std::setw(0))> || std::same_as<T, decltype(std::setprecision(0))> ||
+  std::same_as<T, decltype(std::setfill(' '))> || std::same_as<T, decltype(std::setbase(10))>;
+
+/// Thread local line buffers, one per nesting level (a WLOG argument may log itself)
+struct LineBuffers {
+/// Change below constants if needed
+  static constexpr size_t DEPTH               = 4;
+  static constexpr size_t DEFAULT_BUFFER_SIZE = 256;
+
+  std::string bufs[DEPTH];
+  uint8_t     depth {0};
+
+  explicit LineBuffers() {
+    for (std::string& buf : bufs) buf.reserve(DEFAULT_BUFFER_SIZE);
+  }
+};
+
+inline thread_local LineBuffers tl_lines {};
+
+/// Wraps a value printed as "<unprintable>" if it cannot be formatted
+template <typename T>
+struct Operand {
+  const T& VAL;
+};
+
+/// Operand computed only once the line is built, same shape as warp::log::lazy
+template <std::invocable F>
+struct Lazy {
+  F fn;
+};
+
+template <typename F>
+[[nodiscard]] constexpr Lazy<std::decay_t<F>> lazy(F&& fn) { return {std::forward<F>(fn)}; }
+
+/// Lets lazy operands go to plain streams too, e.g. WLOG_BYPASS
+template <typename F>
+std::ostream& operator<<(std::ostream& os, const Lazy<F>& arg) { return os << std::invoke(arg.fn); }
+
+/// Sink of the DISABLE_LOGGING macros : accepts every operand WLOG does, never evaluated
+struct NullLine {
+  template <typename T>
+  const NullLine& operator<<(const T&) const noexcept { return *this; }
+
+  const NullLine& operator<<(std::ios_base& (*)(std::ios_base&)) const noexcept { return *this; }
+  const NullLine& operator<<(std::ostream& (*)(std::ostream&)) const noexcept { return *this; }
+};
+
+static_assert(requires (const NullLine& line) {
+  line << lazy([] { return 0; }) << std::hex << std::setw(2) << std::endl << "text";
+}, "NullLine must accept everything a LogLine does");
+
+/// Builds one log line without iostream and writes it once on destruction
+/// Numbers use std::to_chars, strings are copied, other types use std::formatter
+/// and only fall back to operator<< if they have no formatter
+/// Once a manipulator (std::hex, std::setw, ...) is streamed, the rest of the line is formatted
+/// through a private std::ostringstream carrying that state, like std::cout would
+class LogLine {
+private:
+  std::string                         _overflow {}; // used only past LineBuffers::DEPTH nested lines
+  std::string&                        _buf;
+  LogLevel                            _level;
+  bool                                _color;
+  std::unique_ptr<std::ostringstream> _fmt      {}; // created by the first manipulator
+
+  std::ostringstream& _fmtStream() {
+    if (!_fmt) _fmt = std::make_unique<std::ostringstream>();
+    return *_fmt;
+  }
+
+  /// Formats `val` with the manipulated stream state, false while no manipulator was seen
+  template <typename T>
+  bool _streamed(const T& val) {
+    if (!_fmt) [[likely]] return false;
+    _fmt->str({});
+    *_fmt << val;
+    _buf.append(_fmt->view());
+    return true;
+  }
+
+  template <typename T>
+  void _appendChars(T val, int base = 10) {
+    char chars[64];
+    const auto [END, _] {std::to_chars(chars, chars + sizeof(chars), val, base)};
+    _buf.append(chars, END);
+  }
+
+  template <typename T>
+  void _appendFloat(T val) {
+    char chars[64];
+    const auto [END, _] {std::to_chars(chars, chars + sizeof(chars), val, std::chars_format::general, 6)}; // like std::cout
+    _buf.append(chars, END);
+  }
+
+public:
+  explicit LogLine(LogLevel level) noexcept
+  : _buf   {tl_lines.depth < LineBuffers::DEPTH ? tl_lines.bufs[tl_lines.depth] : _overflow}
+  , _level {level}
+  , _color {sinkColor(level)} {
+    ++tl_lines.depth;
+    _buf.clear();
+  }
+
+  LogLine(const LogLine&) = delete;
+  LogLine& operator=(const LogLine&) = delete;
+
+  ~LogLine() noexcept {
+    s_core.write(_level, _buf);
+    --tl_lines.depth;
+  }
+
+  LogLine& operator<<(std::string_view text) {
+    if (!_streamed(text)) _buf.append(text);
+    return *this;
+  }
+
+  LogLine& operator<<(const char* text)        { return *this << std::string_view {text ? text : "(null)"}; }
+  LogLine& operator<<(char* text)              { return *this << static_cast<const char*>(text); }
+  LogLine& operator<<(const std::string& text) { return *this << std::string_view {text}; }
+
+  LogLine& operator<<(bool val) {
+    if (!_streamed(val)) _buf.push_back(val ? '1' : '0');
+    return *this;
+  }
+
+  LogLine& operator<<(std::nullptr_t) { return *this << std::string_view {"nullptr"}; }
+
+  template <CharType T>
+  LogLine& operator<<(T val) {
+    if (!_streamed(val)) _buf.push_back(static_cast<char>(val));
+    return *this;
+  }
+
+  template <std::integral T> requires (!CharType<T> && !std::same_as<T, bool>)
+  LogLine& operator<<(T val) {
+    if (!_streamed(val)) _appendChars(val);
+    return *this;
+  }
+
+  template <std::floating_point T>
+  LogLine& operator<<(T val) {
+    if (!_streamed(val)) _appendFloat(val);
+    return *this;
+  }
+
+  /// Enums without a formatter use their own operator<< if any, else print their value
+  template <typename T> requires (std::is_enum_v<T> && !Formattable<T>)
+  LogLine& operator<<(T val) {
+    if constexpr (OwnStreamable<T>) {
+      if (_streamed(val)) return *this;
+
+      std::ostringstream oss;
+      oss << val;
+      _buf.append(oss.view());
+      return *this;
+    } else {
+      return *this << static_cast<long long>(static_cast<std::underlying_type_t<T>>(val));
+    }
+  }
+
+  LogLine& operator<<(const void* ptr) {
+    if (_streamed(ptr)) return *this;
+    _buf.append("0x");
+    _appendChars(reinterpret_cast<uintptr_t>(ptr), 16);
+    return *this;
+  }
+
+  /// std::hex, std::dec, std::fixed, std::boolalpha, ...
+  LogLine& operator<<(std::ios_base& (*manip)(std::ios_base&)) {
+    manip(_fmtStream());
+    return *this;
+  }
+
+  /// std::endl, std::flush : the line is written once anyway, only the text is kept
+  LogLine& operator<<(std::ostream& (*manip)(std::ostream&)) {
+    std::ostringstream& os {_fmtStream()};
+    os.str({});
+    manip(os);
+    _buf.append(os.view());
+    return *this;
+  }
+
+  /// std::setw, std::setprecision, std::setfill, std::setbase
+  template <StateManip T>
+  LogLine& operator<<(const T& manip) {
+    _fmtStream() << manip;
+    return *this;
+  }
+
+  LogLine& operator<<(Ansi ansi) {
+    if (_color) _buf.append(ansi.CODE);
+    return *this;
+  }
+
+  LogLine& operator<<(ColorText text) {
+    if (!_color) return *this << text.TEXT;
+    _buf.append("\033[");
+    _appendChars(text.COLOR_CODE);
+    _buf.push_back('m');
+    _buf.append(text.TEXT).append("\033[0m");
+    return *this;
+  }
+
+  /// Site passed by a helper logging for its caller, nullptr prints nothing
+  LogLine& operator<<([[maybe_unused]] CallSite* site) {
+#if ENABLE_CALL_SITE
+    if (site) *this << site->touch();
+#endif
+    return *this;
+  }
+
+#if ENABLE_CALL_SITE
+  LogLine& operator<<([[maybe_unused]] const CallSite& site) {
+#if ENABLE_CALL_SITE_PREFIX
+    _buf.push_back('[');
+    _buf.append(site.FILE_NAME).push_back(':');
+    _appendChars(site.LINE);
+    _buf.push_back(']');
+#endif
+    return *this;
+  }
+#endif
+
+  template <typename F>
+  LogLine& operator<<(const Lazy<F>& arg) { return *this << std::invoke(arg.fn); }
+
+  template <typename T>
+  LogLine& operator<<(Operand<T> operand) {
+    if constexpr (Formattable<T> || Streamable<T>) return *this << operand.VAL;
+    else                                           return *this << "<unprintable>";
+  }
+
+  template <typename T>
+    requires (!std::is_arithmetic_v<std::remove_cvref_t<T>> && !std::is_pointer_v<std::remove_cvref_t<T>>
+           && !(std::is_enum_v<std::remove_cvref_t<T>> && !Formattable<T>)
+           && !std::is_convertible_v<const T&, std::string_view>
+           && !StateManip<T>
+           && (Formattable<T> || Streamable<T>))
+  LogLine& operator<<(const T& val) {
+    if constexpr (Streamable<T>) {
+      if (_streamed(val)) return *this;
+    }
+
+    if constexpr (Formattable<T>) {
+      std::format_to(std::back_inserter(_buf), "{}", val);
+    } else {
+      std::ostringstream oss;
+      oss << val;
+      _buf.append(oss.view());
+    }
+    return *this;
+  }
+};
 
 } // namespace warp::mini
 
@@ -150,28 +769,48 @@ inline std::ostream& logStream(LogLevel level) {
 /// `os <<`
 
 // Works even if `DISABLE_LOGGING` is defined
-#define WLOG_BYPASS std::cout << "\n\033[0m"
+#define WLOG_BYPASS std::cout << "\n" << warp::mini::Ansi {"\033[0m"}
 
 #ifdef DISABLE_LOGGING
 
 #define WLOG_RAW \
-  if constexpr (false) std::cout
+  if constexpr (false) warp::mini::NullLine {}
 
 #define WLOG(LVL) \
-  if constexpr (false) std::cout
+  if constexpr (false) warp::mini::NullLine {}
+
+#define WLOG_AT(LVL, SITE) \
+  if constexpr (false) warp::mini::NullLine {}
 
 #else
 
 #define WLOG_RAW  WLOG_BYPASS
 
-#define WLOG(LVL)                                  \
-  if constexpr (LVL >= warp::mini::MIN_LOG_LEVEL)  \
-    warp::mini::logStream(LVL)                     \
-      << "\n"                                      \
-      << warp::mini::openColor(LVL)                \
-      << warp::mini::getTimestamp()                \
-      << warp::mini::LEVEL_STR[LVL]                \
-      << warp::mini::closeColor()                  \
+// compile time floor first, then one relaxed load before any stream work
+#define WLOG(LVL)                                      \
+  if constexpr (!(LVL >= warp::mini::MIN_LOG_LEVEL)) {} \
+  else if (!warp::mini::isLogLevelOn(LVL)) {}          \
+  else                                                 \
+    warp::mini::LogLine {LVL}                          \
+      << "\n"                                          \
+      << warp::mini::openColor(LVL)                    \
+      << warp::mini::getTimestamp()                    \
+      << warp::mini::LEVEL_STR[LVL]                    \
+      WLOG_CALL_SITE_IMPL                              \
+      << warp::mini::closeColor() << " : "             \
+
+/// WLOG reporting `SITE` (a CallSite*) instead of its own expansion
+#define WLOG_AT(LVL, SITE)                             \
+  if constexpr (!(LVL >= warp::mini::MIN_LOG_LEVEL)) {} \
+  else if (!warp::mini::isLogLevelOn(LVL)) {}          \
+  else                                                 \
+    warp::mini::LogLine {LVL}                          \
+      << "\n"                                          \
+      << warp::mini::openColor(LVL)                    \
+      << warp::mini::getTimestamp()                    \
+      << warp::mini::LEVEL_STR[LVL]                    \
+      << (SITE)                                        \
+      << warp::mini::closeColor() << " : "             \
 
 #endif
 
@@ -182,50 +821,352 @@ inline std::ostream& logStream(LogLevel level) {
 #define WLOGE  WLOG(L_ERROR)
 #define WLOGF  WLOG(L_FATAL)
 
-namespace warp::mini {
+/// Categories : `WLOG_CATEGORY(net)` once at namespace scope, then `WLOGD_C(net) <<`
 
-/// Automatically logs trace messages for functions
-struct ScopeTracer {
-  std::string FN_NAME;
+#define WLOG_CATEGORY(NAME)                                                 \
+  inline constinit warp::mini::LogCategory wlog_category_##NAME {#NAME};    \
+  inline const bool wlog_category_##NAME##_registered {wlog_category_##NAME.registerSelf()}
+
+#ifdef DISABLE_LOGGING
+
+#define WLOG_C(CATEGORY, LVL) \
+  if constexpr (false) warp::mini::NullLine {}
 
-#if ENABLE_COLOR_CODE
-  static constexpr const char* ENTER_TEXT {"\033[92m" SCOPE_ENTER_TEXT "\033[0m"};
-  static constexpr const char* LEAVE_TEXT {"\033[91m" SCOPE_LEAVE_TEXT "\033[0m"};
 #else
-  static constexpr const char* ENTER_TEXT {SCOPE_ENTER_TEXT};
-  static constexpr const char* LEAVE_TEXT {SCOPE_LEAVE_TEXT};
+
+#define WLOG_C(CATEGORY, LVL)                                \
+  if constexpr (!(LVL >= warp::mini::MIN_LOG_LEVEL)) {}       \
+  else if (!wlog_category_##CATEGORY.isOn(LVL)) {}           \
+  else                                                       \
+    warp::mini::LogLine {LVL}                                \
+      << "\n"                                                \
+      << warp::mini::openColor(LVL)                          \
+      << warp::mini::getTimestamp()                          \
+      << warp::mini::LEVEL_STR[LVL]                          \
+      WLOG_CALL_SITE_IMPL                                    \
+      << "[" #CATEGORY "]"                                   \
+      << warp::mini::closeColor() << " : "                   \
+
 #endif
 
-  explicit ScopeTracer(std::string_view fn_name) : FN_NAME {fn_name} {
-    WLOGT << ENTER_TEXT << " : " << FN_NAME;
+#define WLOGT_C(CATEGORY)  WLOG_C(CATEGORY, L_TRACE)
+#define WLOGD_C(CATEGORY)  WLOG_C(CATEGORY, L_DEBUG)
+#define WLOGI_C(CATEGORY)  WLOG_C(CATEGORY, L_INFO)
+#define WLOGW_C(CATEGORY)  WLOG_C(CATEGORY, L_WARN)
+#define WLOGE_C(CATEGORY)  WLOG_C(CATEGORY, L_ERROR)
+#define WLOGF_C(CATEGORY)  WLOG_C(CATEGORY, L_FATAL)
+
+// per thread trace files are never colored
+#define TRACE_COLOR_CODE  ((ENABLE_COLOR_CODE) && !(TRACE_PER_THREAD_FILE))
+
+#if ((TRACE_COLOR_CODE) && (ENABLE_TRACE_DULL))
+#define TRACE_NAME_OPEN   "\033[90m"
+#define TRACE_NAME_CLOSE  "\033[0m"
+#else
+#define TRACE_NAME_OPEN   ""
+#define TRACE_NAME_CLOSE  ""
+#endif
+
+namespace warp::mini {
+
+#ifdef DISABLE_LOGGING
+inline constexpr bool TRACE_LOG_ENABLED {false};
+#else
+inline constexpr bool TRACE_LOG_ENABLED {L_TRACE >= MIN_LOG_LEVEL};
+#endif
+
+inline constexpr bool TRACE_ENABLED {TRACE_LOG_ENABLED || TRACE_TIMING_MODE == 2};
+
+/// Null terminated name built at compile time
+template <size_t N>
+struct TraceName {
+  char str[N] {};
+};
+
+/// Concatenates string literals (and `__FUNCTION__`) at compile time
+template <size_t... Ns>
+[[nodiscard]] consteval auto makeTraceName(const char (&... parts)[Ns]) noexcept {
+  TraceName<(Ns + ...) - sizeof...(Ns) + 1> name {};
+  size_t pos {0};
+
+  auto append = [&](const char* part, size_t len) {
+    for (size_t i = 0; i < len; ++i) name.str[pos++] = part[i];
+  };
+
+  (append(parts, Ns - 1), ...);
+  return name;
+}
+
+/// Nanosecond duration printed with a readable unit
+struct TraceDuration {
+  uint64_t ns;
+
+  void appendTo(std::string& out) const {
+    auto it {std::back_inserter(out)};
+    if      (ns < 1'000)         std::format_to(it, "{} ns", ns);
+    else if (ns < 1'000'000)     std::format_to(it, "{:.3f} us", ns / 1e3);
+    else if (ns < 1'000'000'000) std::format_to(it, "{:.3f} ms", ns / 1e6);
+    else                         std::format_to(it, "{:.3f} s", ns / 1e9);
   }
+};
 
-  ~ScopeTracer() {
-    WLOGT << LEAVE_TEXT << " : " << FN_NAME;
+/// --- Per thread trace state ---
+
+/// Depth, label and output of the calling thread's trace tree
+struct ThreadTraceContext {
+  uint32_t    id    {s_core.next_thread.fetch_add(1, std::memory_order_relaxed)};
+  uint32_t    depth {0};
+  std::string name  {};
+  std::string line  {};
+
+#if TRACE_PER_THREAD_FILE
+  std::FILE* file {nullptr};
+
+  ~ThreadTraceContext() { if (file) std::fclose(file); }
+
+  /// Lazily opens "warp_trace_<thread>.log" or "warp_trace_<name>_<thread>.log", owned by this thread only
+  /// The thread number keeps threads sharing a name from truncating each other's file
+  [[nodiscard]] std::FILE* getFile() {
+    if (!file) {
+      const std::string PATH {
+        name.empty() ? std::format("warp_trace_{}.log", id) : std::format("warp_trace_{}_{}.log", name, id)
+      };
+      file = std::fopen(PATH.c_str(), "w");
+    }
+    return file;
   }
+#endif
+};
+
+inline thread_local ThreadTraceContext tl_trace_ctx {};
+
+/// Labels the calling thread in trace lines instead of its numeric id
+inline void setTraceThreadName(std::string_view name) { tl_trace_ctx.name = name; }
 
+// [color][enter]
+inline constexpr const char* TRACE_MARKER[2][2] {
+  {SCOPE_LEAVE_TEXT, SCOPE_ENTER_TEXT},
+  {"\033[91m" SCOPE_LEAVE_TEXT "\033[0m", "\033[92m" SCOPE_ENTER_TEXT "\033[0m"},
 };
 
-} // namespace warp::mini
+/// Writes `[thread] <indent><marker> : <fn>()` for the calling thread
+inline void writeTraceLine(
+  bool enter,
+  const char* fn_name,
+  uint32_t depth,
+  [[maybe_unused]] CallSite* site,
+  const TraceDuration* elapsed = nullptr
+) {
+  if (!isLogLevelOn(L_TRACE)) return;
+
+  ThreadTraceContext& ctx {tl_trace_ctx};
+  std::string& line {ctx.line};
+  line.clear();
+
+#if TRACE_PER_THREAD_FILE
+  line.append(getTimestamp());
+#endif
 
-/// ScopeTracer {fn};
+#if ENABLE_TRACE_THREAD_ID
+  if (ctx.name.empty()) std::format_to(std::back_inserter(line), "[T{}] ", ctx.id);
+  else                  std::format_to(std::back_inserter(line), "[{}] ", ctx.name);
+#endif
+
+#if ENABLE_TRACE_INDENT
+  for (uint32_t i = 0; i < depth; ++i) line.append(TRACE_INDENT_TEXT);
+#else
+  static_cast<void>(depth);
+#endif
 
-#if ((ENABLE_COLOR_CODE) && (ENABLE_TRACE_DULL))
+  const bool COLOR {TRACE_COLOR_CODE && sinkColor(L_TRACE)};
+  line.append(TRACE_MARKER[COLOR][enter]).append(" : ");
+  if (COLOR) line.append(TRACE_NAME_OPEN).append(fn_name).append(TRACE_NAME_CLOSE);
+  else       line.append(fn_name);
 
-#define WTRACE           warp::mini::ScopeTracer __trace {std::format("\033[90m{}()\033[0m", __FUNCTION__)}
-#define WTRACE_C(CLASS)  warp::mini::ScopeTracer __trace {std::format("\033[90m{}::{}()\033[0m", #CLASS, __FUNCTION__)}
+  if (elapsed) {
+    line.append(" [");
+    elapsed->appendTo(line);
+    line.push_back(']');
+  }
 
+#if TRACE_PER_THREAD_FILE
+  // no shared lock : every thread owns its file
+  if (std::FILE* file {ctx.getFile()}) {
+    line.push_back('\n');
+    std::fwrite(line.data(), 1, line.size(), file);
+  }
 #else
+  WLOG_AT(L_TRACE, site) << line;
+#endif
+}
+
+#if TRACE_TIMING_MODE
+
+using TraceClock = std::chrono::steady_clock;
+
+#if TRACE_TIMING_MODE == 2
+
+/// Aggregated timings of a traced function
+struct TraceStat {
+  uint64_t calls    {0};
+  uint64_t total_ns {0};
+  uint64_t self_ns  {0};
+  uint64_t max_ns   {0};
+
+  void add(uint64_t total, uint64_t self) noexcept {
+    ++calls;
+    total_ns += total;
+    self_ns  += self;
+    max_ns    = std::max(max_ns, total);
+  }
+
+  void merge(const TraceStat& other) noexcept {
+    calls    += other.calls;
+    total_ns += other.total_ns;
+    self_ns  += other.self_ns;
+    max_ns    = std::max(max_ns, other.max_ns);
+  }
+};
+
+using TraceStatMap = std::unordered_map<std::string_view, TraceStat>;
+
+/// Process wide trace timings, merged from every thread and printed at exit
+class TraceProfile {
+private:
+  std::mutex   _mutex {};
+  TraceStatMap _stats {};
+
+public:
+  void merge(const TraceStatMap& stats) {
+    std::scoped_lock lock {_mutex};
+    for (const auto& [NAME, STAT] : stats) _stats[NAME].merge(STAT);
+  }
+
+  ~TraceProfile() {
+    if (_stats.empty()) return;
+
+    std::vector<std::pair<std::string_view, TraceStat>> rows {_stats.begin(), _stats.end()};
+    std::sort(rows.begin(), rows.end(), [](const auto& a, const auto& b) {
+      return a.second.total_ns > b.second.total_ns;
+    });
+
+    std::cout << std::format("\n{:<40} {:>10} {:>14} {:>14} {:>14}\n", "[TRACE PROFILE]", "calls", "total", "self", "max");
+    for (const auto& [NAME, STAT] : rows) {
+      std::cout << std::format(
+        "{:<40} {:>10} {:>14.3f} {:>14.3f} {:>14.3f}\n",
+        NAME, STAT.calls, STAT.total_ns / 1e6, STAT.self_ns / 1e6, STAT.max_ns / 1e6
+      );
+    }
+    std::cout << std::format("{:<40} {:>10} {:>14} {:>14} {:>14}\n", "", "", "(ms)", "(ms)", "(ms)");
+  }
+};
+
+inline TraceProfile& traceProfile() {
+  static TraceProfile s_profile {};
+  return s_profile;
+}
+
+#endif
+
+/// Per thread call stack of entry timestamps
+struct ThreadTraceBuffer {
+  struct Frame {
+    TraceClock::time_point start;
+    uint64_t               child_ns;
+  };
+
+  Frame    frames[TRACE_MAX_DEPTH];
+  uint32_t depth {0};
+
+#if TRACE_TIMING_MODE == 2
+  TraceStatMap stats {};
+
+  // constructs the profile first so that it outlives every thread buffer
+  ThreadTraceBuffer() { static_cast<void>(traceProfile()); }
+  ~ThreadTraceBuffer() { traceProfile().merge(stats); }
+#endif
+
+  void enter() noexcept {
+    if (depth < TRACE_MAX_DEPTH) frames[depth] = {TraceClock::now(), 0};
+    ++depth;
+  }
+
+  /// Returns the elapsed nanoseconds of the innermost scope
+  uint64_t leave([[maybe_unused]] std::string_view name) noexcept {
+    const auto NOW {TraceClock::now()};
+    if (--depth >= TRACE_MAX_DEPTH) return 0;
+
+    const Frame& FRAME {frames[depth]};
+    const uint64_t ELAPSED {static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(NOW - FRAME.start).count()
+    )};
+
+    if (depth > 0) frames[depth - 1].child_ns += ELAPSED;
+
+#if TRACE_TIMING_MODE == 2
+    stats[name].add(ELAPSED, ELAPSED - std::min(ELAPSED, FRAME.child_ns));
+#endif
+    return ELAPSED;
+  }
+};
 
-#define WTRACE           warp::mini::ScopeTracer __trace {std::format("{}()", __FUNCTION__)}
-#define WTRACE_C(CLASS)  warp::mini::ScopeTracer __trace {std::format("{}::{}()", #CLASS, __FUNCTION__)}
+inline thread_local ThreadTraceBuffer tl_trace {};
 
 #endif
 
+/// Automatically logs trace messages for functions
+template <bool Enabled = TRACE_ENABLED>
+struct ScopeTracer {
+  const char*     FN_NAME;
+  CallSite* const SITE; // WTRACE use site, reported instead of this header
+
+  explicit ScopeTracer(const char* fn_name, CallSite* site = nullptr) noexcept : FN_NAME {fn_name}, SITE {site} {
+    if constexpr (TRACE_LOG_ENABLED) writeTraceLine(true, FN_NAME, tl_trace_ctx.depth++, SITE);
+#if TRACE_TIMING_MODE
+    tl_trace.enter();
+#endif
+  }
+
+  ~ScopeTracer() noexcept {
+#if TRACE_TIMING_MODE == 1
+    const TraceDuration ELAPSED {tl_trace.leave(FN_NAME)};
+    if constexpr (TRACE_LOG_ENABLED) writeTraceLine(false, FN_NAME, --tl_trace_ctx.depth, SITE, &ELAPSED);
+#else
+#if TRACE_TIMING_MODE == 2
+    tl_trace.leave(FN_NAME);
+#endif
+    if constexpr (TRACE_LOG_ENABLED) writeTraceLine(false, FN_NAME, --tl_trace_ctx.depth, SITE);
+#endif
+  }
+
+};
+
+/// Trace disabled : no state, no code
+template <>
+struct ScopeTracer<false> {
+  constexpr explicit ScopeTracer(const char*, CallSite* = nullptr) noexcept {}
+};
+
+} // namespace warp::mini
+
+/// ScopeTracer {fn};
+
+#define WTRACE_IMPL(...)                                                  \
+  static constexpr auto wtrace_name_ {                                    \
+    warp::mini::makeTraceName(__VA_ARGS__, "()")                          \
+  };                                                                      \
+  [[maybe_unused]] const warp::mini::ScopeTracer<> wtrace_ {              \
+    wtrace_name_.str,                                                     \
+    warp::mini::TRACE_LOG_ENABLED ? WLOG_SITE_HERE : nullptr              \
+  }
+
+#define WTRACE           WTRACE_IMPL(__FUNCTION__)
+#define WTRACE_C(CLASS)  WTRACE_IMPL(#CLASS "::", __FUNCTION__)
+
 /// `if (flag) os <<`
 
 #define WLOG_IF(LVL, CONDITION) \
-  if (CONDITION) WLOG(LVL)
+  if (!(CONDITION)) {} else WLOG(LVL)
 
 #define WLOGT_IF(CONDITION)  WLOG_IF(L_TRACE, CONDITION)
 #define WLOGD_IF(CONDITION)  WLOG_IF(L_DEBUG, CONDITION)
@@ -246,32 +1187,158 @@ struct ScopeTracer {
 #define WTEST_EQ(ACTUAL, EXPECTED)  WTEST((ACTUAL) == (EXPECTED))
 #define WTEST_NE(ACTUAL, EXPECTED)  WTEST((ACTUAL) != (EXPECTED))
 
-/// `if (!flag) WLOGF << flag; abort();`
+/// --- Assertions ---
 
-#define WASSERT(CONDITION) do {                 \
-  if (!(CONDITION)) {                           \
-    WLOGF                                       \
-      << warp::mini::colorText(41, "[ASSERT]")  \
-      << " : " #CONDITION "\n";                 \
-    std::abort();                               \
-  }                                             \
+#if defined(__GNUC__) || defined(__clang__)
+#define WCOLD  [[gnu::cold, gnu::noinline]]
+#elif defined(_MSC_VER)
+#define WCOLD  __declspec(noinline)
+#else
+#define WCOLD
+#endif
+
+namespace warp::mini {
+
+// Diagnostics before an abort skip the runtime level and DISABLE_LOGGING : a process never aborts silently
+// WTODO keeps the WARN level it always had
+
+[[noreturn]] WCOLD inline void assertFailed(const char* cond, const char* file, int line) noexcept {
+  LogLine {L_FATAL}
+    << "\n"
+    << colorText(41, "[ASSERT]")
+    << " : " << cond << " : (" << file << ") : " << line << "\n";
+  killProcess();
+}
+
+/// Prints both operands of the failed comparison
+template <typename L, typename R>
+[[noreturn]] WCOLD inline void assertCmpFailed(
+  const char* cond, const char* file, int line, const L& lhs, const R& rhs
+) noexcept {
+  LogLine {L_FATAL}
+    << "\n"
+    << colorText(41, "[ASSERT]")
+    << " : " << cond << " : (" << file << ") : " << line
+    << "\n\tlhs : " << Operand<L> {lhs}
+    << "\n\trhs : " << Operand<R> {rhs} << "\n";
+  killProcess();
+}
+
+WCOLD inline void expectFailed(const char* cond, const char* file, int line, [[maybe_unused]] CallSite* site) noexcept {
+  WLOG_AT(L_ERROR, site)
+    << colorText(31, "[EXPECT]")
+    << " : " << cond << " : (" << file << ") : " << line << "\n";
+}
+
+/// Prints both operands of the failed comparison
+template <typename L, typename R>
+WCOLD inline void expectCmpFailed(
+  const char* cond, const char* file, int line, [[maybe_unused]] CallSite* site, const L& lhs, const R& rhs
+) noexcept {
+  WLOG_AT(L_ERROR, site)
+    << colorText(31, "[EXPECT]")
+    << " : " << cond << " : (" << file << ") : " << line
+    << "\n\tlhs : " << Operand<L> {lhs}
+    << "\n\trhs : " << Operand<R> {rhs} << "\n";
+}
+
+[[noreturn]] WCOLD inline void todoReached(const char* msg, const char* file, const char* fn, int line) noexcept {
+  LogLine {L_WARN}
+    << "\n"
+    << colorText(33, "[TODO]")
+    << " : " << msg << " : (" << file
+    << ") @ " << fn
+    << "() : " << line << "\n";
+  killProcess();
+}
+
+[[noreturn]] WCOLD inline void unreachableReached(const char* file, const char* fn, int line) noexcept {
+  LogLine {L_FATAL}
+    << "\n"
+    << colorText(41, "[UNREACHABLE]")
+    << " : (" << file
+    << ") @ " << fn
+    << "() : " << line << "\n";
+  killProcess();
+}
+
+} // namespace warp::mini
+
+#if defined(__clang__)
+#define WASSUME_IMPL(CONDITION)  __builtin_assume(CONDITION)
+#elif defined(_MSC_VER)
+#define WASSUME_IMPL(CONDITION)  __assume(CONDITION)
+#elif defined(__has_cpp_attribute) && __has_cpp_attribute(assume)
+#define WASSUME_IMPL(CONDITION)  [[assume(CONDITION)]]
+#elif defined(__GNUC__)
+#define WASSUME_IMPL(CONDITION)  do { if (!(CONDITION)) __builtin_unreachable(); } while (0)
+#else
+#define WASSUME_IMPL(CONDITION)  static_cast<void>(0)
+#endif
+
+/// Always on : `if (!flag) [[unlikely]] WLOGF << flag; abort();`
+
+#define WASSERT(CONDITION) do {                                               \
+  if (!(CONDITION)) [[unlikely]]                                              \
+    warp::mini::assertFailed(#CONDITION, __FILE__, __LINE__);                 \
+} while (0)
+
+#define WASSERT_CMP(ACTUAL, EXPECTED, OP) do {                                \
+  const auto& wassert_lhs_ {ACTUAL};                                          \
+  const auto& wassert_rhs_ {EXPECTED};                                        \
+  if (!(wassert_lhs_ OP wassert_rhs_)) [[unlikely]]                           \
+    warp::mini::assertCmpFailed(                                              \
+      #ACTUAL " " #OP " " #EXPECTED, __FILE__, __LINE__,                      \
+      wassert_lhs_, wassert_rhs_                                              \
+    );                                                                        \
 } while (0)
 
-#define WASSERT_EQ(ACTUAL, EXPECTED)  WASSERT((ACTUAL) == (EXPECTED))
-#define WASSERT_NE(ACTUAL, EXPECTED)  WASSERT((ACTUAL) != (EXPECTED))
+#define WASSERT_EQ(ACTUAL, EXPECTED)  WASSERT_CMP(ACTUAL, EXPECTED, ==)
+#define WASSERT_NE(ACTUAL, EXPECTED)  WASSERT_CMP(ACTUAL, EXPECTED, !=)
+
+/// Debug only : not evaluated under NDEBUG
 
-/// `if (!flag) WLOGE << flag`
+#ifdef NDEBUG
 
-#define WEXPECT(CONDITION) do {                 \
-  if (!(CONDITION)) {                           \
-    WLOGE                                       \
-      << warp::mini::colorText(31, "[EXPECT]")  \
-      << " : " #CONDITION "\n";                 \
-  }                                             \
+#define WDEBUG_ASSERT(CONDITION)             static_cast<void>(sizeof(!(CONDITION)))
+#define WDEBUG_ASSERT_EQ(ACTUAL, EXPECTED)   static_cast<void>(sizeof((ACTUAL) == (EXPECTED)))
+#define WDEBUG_ASSERT_NE(ACTUAL, EXPECTED)   static_cast<void>(sizeof((ACTUAL) != (EXPECTED)))
+
+#else
+
+#define WDEBUG_ASSERT(CONDITION)             WASSERT(CONDITION)
+#define WDEBUG_ASSERT_EQ(ACTUAL, EXPECTED)   WASSERT_EQ(ACTUAL, EXPECTED)
+#define WDEBUG_ASSERT_NE(ACTUAL, EXPECTED)   WASSERT_NE(ACTUAL, EXPECTED)
+
+#endif
+
+/// Checked in debug, optimizer hint under NDEBUG (false condition is undefined behaviour)
+
+#ifdef NDEBUG
+#define WASSUME(CONDITION)  WASSUME_IMPL(CONDITION)
+#else
+#define WASSUME(CONDITION)  WASSERT(CONDITION)
+#endif
+
+/// `if (!flag) [[unlikely]] WLOGE << flag`
+
+#define WEXPECT(CONDITION) do {                                               \
+  if (!(CONDITION)) [[unlikely]]                                              \
+    warp::mini::expectFailed(#CONDITION, __FILE__, __LINE__, WLOG_SITE_HERE); \
 } while (0)
 
-#define WEXPECT_EQ(ACTUAL, EXPECTED)  WEXPECT((ACTUAL) == (EXPECTED))
-#define WEXPECT_NE(ACTUAL, EXPECTED)  WEXPECT((ACTUAL) != (EXPECTED))
+#define WEXPECT_CMP(ACTUAL, EXPECTED, OP) do {                                \
+  const auto& wexpect_lhs_ {ACTUAL};                                          \
+  const auto& wexpect_rhs_ {EXPECTED};                                        \
+  if (!(wexpect_lhs_ OP wexpect_rhs_)) [[unlikely]]                           \
+    warp::mini::expectCmpFailed(                                              \
+      #ACTUAL " " #OP " " #EXPECTED, __FILE__, __LINE__, WLOG_SITE_HERE,      \
+      wexpect_lhs_, wexpect_rhs_                                              \
+    );                                                                        \
+} while (0)
+
+#define WEXPECT_EQ(ACTUAL, EXPECTED)  WEXPECT_CMP(ACTUAL, EXPECTED, ==)
+#define WEXPECT_NE(ACTUAL, EXPECTED)  WEXPECT_CMP(ACTUAL, EXPECTED, !=)
 
 /// Developement Macros
 
@@ -282,22 +1349,10 @@ struct ScopeTracer {
 
 #else
 
-#define WTODO(MSG) do {                     \
-  WLOGW                                     \
-    << warp::mini::colorText(33, "[TODO]")  \
-    << " : " MSG " : (" << __FILE__         \
-    << ") @ " << __FUNCTION__               \
-    << "() : " << __LINE__ << "\n";         \
-  warp::mini::killProcess();                \
-} while(0)
-
-#define WUNREACHABLE do {                          \
-  WLOGF                                            \
-    << warp::mini::colorText(41, "[UNREACHABLE]")  \
-    << " : (" << __FILE__                          \
-    << ") @ " << __FUNCTION__                      \
-    << "() : " << __LINE__ << "\n";                \
-  warp::mini::killProcess();                       \
-} while(0)
+#define WTODO(MSG) \
+  warp::mini::todoReached(MSG, __FILE__, __FUNCTION__, __LINE__)
+
+#define WUNREACHABLE \
+  warp::mini::unreachableReached(__FILE__, __FUNCTION__, __LINE__)
 
 #endif
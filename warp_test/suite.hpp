@@ -4,6 +4,7 @@
 
 #include "warp_log/logger.hpp"
 
+#include <string>
 #include <iostream>
 #include <string_view>
 
@@ -17,9 +18,16 @@ private:
 
   void _logTestCase(bool cond, std::string_view desc) noexcept {
     static const log::Tag CASE_TAG = log::makeColoredTag(log::ANSIFore::Blue, "\t\t[CASE]");
-    static const log::Tag PASS_TAG = log::makeColoredTag(log::ANSIFore::Green, "[PASS]");
-    static const log::Tag FAIL_TAG = log::makeColoredTag(log::ANSIFore::Red, "[FAIL]");
-    std::cout << CASE_TAG << (cond ? PASS_TAG : FAIL_TAG) << " : " << desc << '\n';
+    static const log::Tag PASS_PRE = CASE_TAG + log::makeColoredTag(log::ANSIFore::Green, "[PASS]");
+    static const log::Tag FAIL_PRE = CASE_TAG + log::makeColoredTag(log::ANSIFore::Red, "[FAIL]");
+    static const log::Tag PASS_PRE_PLAIN = log::internal::stripAnsi(PASS_PRE);
+    static const log::Tag FAIL_PRE_PLAIN = log::internal::stripAnsi(FAIL_PRE);
+
+    // stdout and no thread context, so piped test output stays where it always was
+    const bool COLOR {log::internal::s_core.sinkColor(false)};
+    std::string line {COLOR ? (cond ? PASS_PRE : FAIL_PRE) : (cond ? PASS_PRE_PLAIN : FAIL_PRE_PLAIN)};
+    line.append(" : ").append(desc).push_back('\n');
+    log::internal::s_core.write(false, line);
   }
 
 public:
@@ -3,12 +3,20 @@
 #include "misc.hpp"
 
 #include "warp_log/tag.hpp"
-#include "warp_log/Logger.hpp"
+#include "warp_log/logger.hpp"
 
+#include <span>
+#include <string>
+#include <format>
+#include <iterator>
+#include <cmath>
+#include <random>
 #include <vector>
 #include <numeric>
+#include <limits>
 #include <algorithm>
 #include <functional>
+#include <initializer_list>
 
 namespace warp::timer::internal {
 
@@ -21,6 +29,67 @@ namespace warp::timer::internal {
   return std::chrono::duration<double, std::milli>(STOP - START).count();
 }
 
+/// Change below constants if needed
+inline constexpr size_t   CALIBRATION_SAMPLES    = 1024;
+inline constexpr double   RESOLUTION_WARN_FACTOR = 4.0;
+inline constexpr uint32_t COMPARE_ROUNDS         = 32;
+
+/// Smallest step seen between two distinct clock reads
+[[nodiscard]] inline double measureClockResolutionNS() noexcept {
+  using Clock = std::chrono::high_resolution_clock;
+  double best {std::numeric_limits<double>::max()};
+
+  for (int i = 0; i < 64; ++i) {
+    const auto START {Clock::now()};
+    auto now {Clock::now()};
+    while (now == START) now = Clock::now();
+    best = std::min(best, std::chrono::duration<double, std::nano>(now - START).count());
+  }
+  return best;
+}
+
+} // namespace warp::timer::internal
+
+namespace warp::timer {
+
+/// Cost of measuring an empty region, sampled once per process
+struct TimerOverhead {
+  double min_ns;
+  double median_ns;
+  double p90_ns;
+  double resolution_ns;
+
+  /// Removes the typical overhead from a raw measurement, never below zero
+  [[nodiscard]] double correctMS(double raw_ms) const noexcept { return std::max(0.0, raw_ms - median_ns * 1e-6); }
+};
+
+} // namespace warp::timer
+
+namespace warp::timer::internal {
+
+[[nodiscard]] inline TimerOverhead calibrateOverhead() noexcept {
+  const std::function<void()> EMPTY {[] {}};
+
+  for (int i = 0; i < 32; ++i) (void)measureCallableTimeMS(EMPTY); // warm up
+
+  std::vector<double> samples(CALIBRATION_SAMPLES);
+  for (double& sample : samples) sample = measureCallableTimeMS(EMPTY) * 1e6;
+  std::sort(samples.begin(), samples.end());
+
+  return {
+    samples.front(),
+    samples[samples.size() / 2],
+    samples[samples.size() * 9 / 10],
+    measureClockResolutionNS()
+  };
+}
+
+/// Measured on first use so including the header costs nothing at startup
+[[nodiscard]] inline const TimerOverhead& timerOverhead() noexcept {
+  static const TimerOverhead OVERHEAD {calibrateOverhead()};
+  return OVERHEAD;
+}
+
 [[nodiscard]] inline std::pair<double, double> getMeanAndMedian(const std::vector<double> sorted_ls) noexcept {
   const size_t SIZE {sorted_ls.size()};
 
@@ -31,13 +100,18 @@ namespace warp::timer::internal {
 }
 
 inline void logElapsed(std::string_view desc, double elapsed, TimeUnit unit) noexcept {
-  log::Logger {
-    log::makeColoredTag(log::ANSIFore::Blue, "[TIMER]")
-  } .msg("{} : {}\n", formatElapsed(elapsed, unit), desc);
+  static const log::Logger TIMER_LOG {log::makeColoredTag(log::ANSIFore::Blue, "[TIMER]")};
+
+  const DurationText ELAPSED {elapsed, unit};
+  TIMER_LOG.msg("{} : {}\n", ELAPSED.view(), desc);
 }
 
+/// `results` have the calibrated timer overhead subtracted, the removed amount is reported with them
 inline void logBenchmark(std::string_view desc, std::vector<double>& results, TimeUnit time_unit) noexcept {
   static const log::Logger BENCHMARK_LOG {makeColoredTag(log::ANSIFore::Blue, "[TIMER][BENCHMARK]")};
+  static const log::Tag    MEAN_TAG      {log::makeColoredTag(log::ANSIFore::Green, "[MEAN]     ")};
+  static const log::Tag    MEDIAN_TAG    {log::makeColoredTag(log::ANSIFore::Green, "[MEDIAN]   ")};
+  static const log::Tag    OVERHEAD_TAG  {log::makeColoredTag(log::ANSIFore::Green, "[OVERHEAD] ")};
 
   if (results.empty()) [[unlikely]] {
     BENCHMARK_LOG.warn("Trying to benchmark empty results");
@@ -46,15 +120,151 @@ inline void logBenchmark(std::string_view desc, std::vector<double>& results, Ti
 
   std::sort(results.begin(), results.end());
   const auto [MEAN, MEDIAN] {getMeanAndMedian(results)};
+  const DurationText MEAN_TEXT   {MEAN, time_unit};
+  const DurationText MEDIAN_TEXT {MEDIAN, time_unit};
+
+  const TimerOverhead& OVERHEAD {timerOverhead()};
+  const DurationText OVERHEAD_TEXT {OVERHEAD.median_ns, TimeUnit::Auto};
+  const DurationText SPREAD_TEXT   {OVERHEAD.p90_ns - OVERHEAD.min_ns, TimeUnit::Auto};
 
   BENCHMARK_LOG.msg(
     "{}\n"
     "\t{}: {}\n"
-    "\t{}: {}\n",
+    "\t{}: {}\n"
+    "\t{}: {} subtracted, +/- {}\n",
     desc,
-    log::makeColoredTag(log::ANSIFore::Green, "[MEAN]   "), formatElapsed(MEAN, time_unit),
-    log::makeColoredTag(log::ANSIFore::Green, "[MEDIAN] "), formatElapsed(MEDIAN, time_unit)
+    MEAN_TAG, MEAN_TEXT.view(),
+    MEDIAN_TAG, MEDIAN_TEXT.view(),
+    OVERHEAD_TAG, OVERHEAD_TEXT.view(), SPREAD_TEXT.view()
   );
+
+  const double MEDIAN_NS {convertUnit(MEDIAN, time_unit, TimeUnit::NanoSeconds)};
+  if (MEDIAN_NS < RESOLUTION_WARN_FACTOR * OVERHEAD.resolution_ns) {
+    const DurationText RESOLUTION_TEXT {OVERHEAD.resolution_ns, TimeUnit::Auto};
+    BENCHMARK_LOG.warn("{} : median is within {}x of the timer resolution {}", desc, RESOLUTION_WARN_FACTOR, RESOLUTION_TEXT.view());
+  }
+}
+
+/// Two-sided 95% Student t quantile for `df` degrees of freedom
+[[nodiscard]] inline constexpr double tQuantile95(size_t df) noexcept {
+  constexpr double T95[] {
+    12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+    2.201,  2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+    2.080,  2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+  };
+  if (df == 0)   return std::numeric_limits<double>::infinity();
+  if (df <= 30)  return T95[df - 1];
+  if (df <= 60)  return 2.000;
+  if (df <= 120) return 1.980;
+  return 1.960;
+}
+
+/// Speedup of a candidate over the baseline with its 95% confidence interval
+struct Speedup {
+  double ratio;
+  double low;
+  double high;
+  size_t pairs;   // rounds used
+  size_t dropped; // rounds where either sample was 0 after overhead correction
+
+  [[nodiscard]] bool valid() const noexcept { return pairs >= 2; }
+};
+
+/// Paired by round : the mean log ratio cancels drift that hits both candidates of a round alike
+[[nodiscard]] inline Speedup pairedSpeedup(std::span<const double> baseline_ns, std::span<const double> candidate_ns) noexcept {
+  std::vector<double> log_ratios;
+  log_ratios.reserve(baseline_ns.size());
+  for (size_t r = 0; r < baseline_ns.size(); ++r)
+    if (baseline_ns[r] > 0 && candidate_ns[r] > 0) log_ratios.push_back(std::log(baseline_ns[r] / candidate_ns[r]));
+
+  const size_t SIZE {log_ratios.size()};
+  const size_t DROPPED {baseline_ns.size() - SIZE};
+  if (SIZE < 2) return {1.0, 0.0, 0.0, SIZE, DROPPED};
+
+  const double MEAN {std::accumulate(log_ratios.begin(), log_ratios.end(), 0.0) / static_cast<double>(SIZE)};
+  double sum_sq {0.0};
+  for (const double LR : log_ratios) sum_sq += (LR - MEAN) * (LR - MEAN);
+
+  const double HALF_WIDTH {tQuantile95(SIZE - 1) * std::sqrt(sum_sq / static_cast<double>(SIZE - 1) / static_cast<double>(SIZE))};
+  return {std::exp(MEAN), std::exp(MEAN - HALF_WIDTH), std::exp(MEAN + HALF_WIDTH), SIZE, DROPPED};
+}
+
+} // namespace warp::timer::internal
+
+namespace warp::timer {
+
+/// One implementation of a compare() run, the first one is the baseline
+struct Candidate {
+  std::string_view      name;
+  std::function<void()> fn;
+};
+
+} // namespace warp::timer
+
+namespace warp::timer::internal {
+
+[[nodiscard]] inline const log::Logger& compareLog() {
+  static const log::Logger COMPARE_LOG {makeColoredTag(log::ANSIFore::Blue, "[TIMER][COMPARE]")};
+  return COMPARE_LOG;
+}
+
+/// `times` holds `rounds` overhead corrected samples in ns per candidate, candidate after candidate
+/// No ratio is reported for a candidate whose median, or the baseline's, is too close to the timer resolution
+inline void logComparison(std::string_view desc, std::span<const Candidate> candidates, std::span<const double> times, uint32_t rounds) {
+  const double RESOLUTION_NS {timerOverhead().resolution_ns};
+  const double FLOOR_NS      {RESOLUTION_WARN_FACTOR * RESOLUTION_NS};
+
+  const std::span<const double> BASELINE {times.first(rounds)};
+  std::vector<double> sorted;
+  std::string report;
+  double baseline_median {0.0};
+  bool unresolved {false};
+
+  for (size_t i = 0; i < candidates.size(); ++i) {
+    const std::span<const double> SAMPLES {times.subspan(i * rounds, rounds)};
+    sorted.assign(SAMPLES.begin(), SAMPLES.end());
+    std::sort(sorted.begin(), sorted.end());
+    const double MEDIAN_NS {getMeanAndMedian(sorted).second};
+    const DurationText MEDIAN {MEDIAN_NS, TimeUnit::Auto};
+
+    std::format_to(std::back_inserter(report), "\t\033[32m[{}]\033[0m : median {}", candidates[i].name, MEDIAN.view());
+    if (i == 0) {
+      baseline_median = MEDIAN_NS;
+      report += " : baseline\n";
+      continue;
+    }
+
+    if (MEDIAN_NS < FLOOR_NS || baseline_median < FLOOR_NS) {
+      unresolved = true;
+      report += MEDIAN_NS < FLOOR_NS ? " : below timer resolution, no ratio\n" : " : baseline below timer resolution, no ratio\n";
+      continue;
+    }
+
+    const Speedup SPEEDUP {pairedSpeedup(BASELINE, SAMPLES)};
+    if (!SPEEDUP.valid()) {
+      std::format_to(std::back_inserter(report), " : only {} of {} rounds usable, no ratio\n", SPEEDUP.pairs, rounds);
+      continue;
+    }
+
+    const std::string_view VERDICT {
+      SPEEDUP.low > 1.0  ? "\033[32mfaster\033[0m" :
+      SPEEDUP.high < 1.0 ? "\033[31mslower\033[0m" :
+                           "no significant difference"
+    };
+    std::format_to(
+      std::back_inserter(report), " : {:.3f}x [{:.3f}x, {:.3f}x] 95% CI : {}",
+      SPEEDUP.ratio, SPEEDUP.low, SPEEDUP.high, VERDICT
+    );
+    if (SPEEDUP.dropped) std::format_to(std::back_inserter(report), " : {} of {} rounds dropped, 0 after overhead", SPEEDUP.dropped, rounds);
+    report += '\n';
+  }
+
+  compareLog().msg("{} : {} interleaved rounds\n{}", desc, rounds, std::string_view {report});
+
+  if (unresolved) {
+    const DurationText RESOLUTION_TEXT {RESOLUTION_NS, TimeUnit::Auto};
+    compareLog().warn("{} : medians within {}x of the timer resolution {} : time a batch of calls per candidate", desc, RESOLUTION_WARN_FACTOR, RESOLUTION_TEXT.view());
+  }
 }
 
 } // namespace warp::timer::internal
@@ -63,26 +273,75 @@ namespace warp::timer {
 
 /// --- Benchmarking tools ---
 
+/// Empty region cost and clock resolution, measured on first use
+[[nodiscard]] inline const TimerOverhead& getTimerOverhead() noexcept { return internal::timerOverhead(); }
+
 /// Measures the total time taken to execute the given callable function
 template <TimeUnit InTimeUnit = TimeUnit::MilliSeconds>
 inline double measure(std::string_view desc, const std::function<void()>& callable) noexcept {
   const double ELAPSED {
-    internal::convertUnit<TimeUnit::MilliSeconds, InTimeUnit>(internal::measureCallableTimeMS(callable))
+    internal::convertUnit<TimeUnit::MilliSeconds, InTimeUnit>(
+      getTimerOverhead().correctMS(internal::measureCallableTimeMS(callable))
+    )
   };
   internal::logElapsed(desc, ELAPSED, InTimeUnit);
   return ELAPSED;
 }
 
 /// Benchmarks the execution time of the given callable function
+/// Reported figures have the calibrated timer overhead removed
 template <TimeUnit InTimeUnit = TimeUnit::MilliSeconds>
 inline void benchmark(std::string_view desc, const std::function<void()>& callable, uint32_t samples = 8) noexcept {
+  const TimerOverhead& OVERHEAD {getTimerOverhead()};
+
   std::vector<double> results;
   results.reserve(samples);
 
   while (samples--)
-    results.push_back(internal::convertUnit<TimeUnit::MilliSeconds, InTimeUnit>(internal::measureCallableTimeMS(callable)));
+    results.push_back(
+      internal::convertUnit<TimeUnit::MilliSeconds, InTimeUnit>(OVERHEAD.correctMS(internal::measureCallableTimeMS(callable)))
+    );
 
   internal::logBenchmark(desc, results, InTimeUnit);
 }
 
+/// Runs every candidate once per round in a freshly shuffled order, so drift (frequency scaling, heat)
+/// spreads evenly over them, then logs each speedup over the first candidate with a 95% confidence interval
+inline void compare(std::string_view desc, std::span<const Candidate> candidates, uint32_t rounds = internal::COMPARE_ROUNDS) {
+  if (candidates.size() < 2 || rounds < 2) [[unlikely]] {
+    internal::compareLog().warn("{} : comparing needs at least 2 candidates and 2 rounds", desc);
+    return;
+  }
+
+  const TimerOverhead& OVERHEAD {getTimerOverhead()};
+  for (const Candidate& CANDIDATE : candidates) CANDIDATE.fn(); // warm up
+
+  std::vector<double> times(candidates.size() * rounds);
+  std::vector<size_t> order(candidates.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::mt19937 rng {std::random_device {}()};
+
+  for (uint32_t r = 0; r < rounds; ++r) {
+    std::shuffle(order.begin(), order.end(), rng);
+    for (const size_t I : order)
+      times[I * rounds + r] = OVERHEAD.correctMS(internal::measureCallableTimeMS(candidates[I].fn)) * 1e6;
+  }
+
+  internal::logComparison(desc, candidates, times, rounds);
+}
+
+/// `compare("parse", {{"old", parseOld}, {"new", parseNew}, {"simd", parseSimd}})`
+inline void compare(std::string_view desc, std::initializer_list<Candidate> candidates, uint32_t rounds = internal::COMPARE_ROUNDS) {
+  compare(desc, std::span<const Candidate> {candidates.begin(), candidates.size()}, rounds);
+}
+
+/// `compare("parse", {"old", parseOld}, {"new", parseNew})`
+inline void compare(std::string_view desc, const Candidate& baseline, const Candidate& other, uint32_t rounds = internal::COMPARE_ROUNDS) {
+  compare(desc, {baseline, other}, rounds);
+}
+
+inline void compare(std::string_view desc, const Candidate& baseline, const Candidate& other, const Candidate& another, uint32_t rounds = internal::COMPARE_ROUNDS) {
+  compare(desc, {baseline, other, another}, rounds);
+}
+
 } // namespace warp::timer
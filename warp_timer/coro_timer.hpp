@@ -0,0 +1,157 @@
+#pragma once
+
+#include "misc.hpp"
+#include "timer.hpp"
+
+#include "warp_log/tag.hpp"
+#include "warp_log/logger.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <utility>
+#include <coroutine>
+#include <string_view>
+#include <type_traits>
+
+namespace warp::timer::internal {
+
+/// --- Awaiter utils ---
+
+template <typename A>
+concept HasMemberCoAwait = requires (A&& a) { std::forward<A>(a).operator co_await(); };
+
+template <typename A>
+concept HasFreeCoAwait = requires (A&& a) { operator co_await(std::forward<A>(a)); };
+
+/// Resolves `operator co_await` the way the compiler does for a plain `co_await a`
+template <typename A>
+[[nodiscard]] decltype(auto) getAwaiter(A&& awaitable) {
+  if constexpr (HasMemberCoAwait<A>)    return std::forward<A>(awaitable).operator co_await();
+  else if constexpr (HasFreeCoAwait<A>) return operator co_await(std::forward<A>(awaitable));
+  else                                  return std::forward<A>(awaitable);
+}
+
+inline void logCoroElapsed(std::string_view desc, double active, double wall, TimeUnit unit, uint32_t suspensions, uint32_t migrations) {
+  static const log::Logger TIMER_LOG {log::makeColoredTag(log::ANSIFore::Blue, "[TIMER]")};
+
+  const DurationText ACTIVE {active, unit};
+  const DurationText WALL   {wall, unit};
+  TIMER_LOG.msg(
+    "{} : {} : wall {} : {} suspensions, {} resumed on another thread\n",
+    ACTIVE.view(), desc, WALL.view(), suspensions, migrations
+  );
+}
+
+} // namespace warp::timer::internal
+
+namespace warp::timer {
+
+/// Timer for coroutines : time spent suspended in awaits passed through track() is excluded
+/// Logs active and wall time, with the number of suspensions, like Timer does on stop
+class CoroTimer final : public Timer {
+private:
+  using Clock = std::chrono::steady_clock;
+
+  Clock::time_point _segment_start {Clock::now()};
+  uint64_t          _active_ns     {0};
+  uint64_t          _thread        {internal::currentThreadID()};
+  uint32_t          _suspensions   {0};
+  uint32_t          _migrations    {0};
+  bool              _paused        {false};
+
+  /// State before a pause, put back when a bool await_suspend declines to suspend
+  struct Checkpoint {
+    Clock::time_point segment_start;
+    uint64_t          active_ns;
+    uint32_t          suspensions;
+    bool              paused;
+  };
+
+  [[nodiscard]] Checkpoint _checkpoint() const noexcept { return {_segment_start, _active_ns, _suspensions, _paused}; }
+
+  void _rollback(const Checkpoint& saved) noexcept {
+    _segment_start = saved.segment_start;
+    _active_ns     = saved.active_ns;
+    _suspensions   = saved.suspensions;
+    _paused        = saved.paused;
+  }
+
+  /// Forwards to the wrapped awaiter, pausing the timer only if the coroutine really suspends
+  template <typename Awaiter>
+  struct Tracked {
+    Awaiter    awaiter;
+    CoroTimer& timer;
+
+    [[nodiscard]] bool await_ready() { return awaiter.await_ready(); }
+
+    template <typename Promise>
+    auto await_suspend(std::coroutine_handle<Promise> handle) {
+      if constexpr (std::is_same_v<decltype(awaiter.await_suspend(handle)), bool>) {
+        const Checkpoint SAVED {timer._checkpoint()};
+        timer.pause();
+        if (awaiter.await_suspend(handle)) return true; // may resume on another thread before returning
+
+        timer._rollback(SAVED); // resumed at once on this thread : never suspended
+        return false;
+      } else {
+        timer.pause();
+        return awaiter.await_suspend(handle); // may resume on another thread before returning
+      }
+    }
+
+    decltype(auto) await_resume() {
+      timer.resume();
+      return awaiter.await_resume();
+    }
+  };
+
+public:
+  explicit CoroTimer(std::string_view description, TimeUnit unit = TimeUnit::MilliSeconds) noexcept
+  : Timer {description, unit} {}
+
+  ~CoroTimer() noexcept { if (_is_running) stop(); }
+
+  void start() noexcept = delete;
+  void reset() noexcept = delete;
+
+  void pause() noexcept {
+    if (_paused) return;
+    _active_ns += static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - _segment_start).count());
+    _paused = true;
+    ++_suspensions;
+  }
+
+  void resume() noexcept {
+    if (!_paused) return;
+    _segment_start = Clock::now();
+    _paused = false;
+
+    const uint64_t THREAD {internal::currentThreadID()};
+    _migrations += THREAD != _thread;
+    _thread = THREAD;
+  }
+
+  /// `co_await timer.track(awaitable)` excludes the suspended time of that await
+  /// Lvalue awaiters are kept by reference, rvalues are moved in so a stored `auto t = timer.track(op())` never dangles
+  template <typename A>
+  [[nodiscard]] auto track(A&& awaitable) {
+    using Resolved = decltype(internal::getAwaiter(std::forward<A>(awaitable)));
+    using Awaiter  = std::conditional_t<std::is_rvalue_reference_v<Resolved>, std::remove_cvref_t<Resolved>, Resolved>;
+    return Tracked<Awaiter> {internal::getAwaiter(std::forward<A>(awaitable)), *this};
+  }
+
+  /// Active time so far, in the timer's unit
+  [[nodiscard]] double getActive() const noexcept {
+    uint64_t active_ns {_active_ns};
+    if (!_paused) active_ns += static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - _segment_start).count());
+    return internal::convertUnit(static_cast<double>(active_ns), TimeUnit::NanoSeconds, _UNIT);
+  }
+
+  void stop() noexcept {
+    const double ACTIVE {getActive()};
+    const double WALL   {_stopAndGetElapsed()};
+    internal::logCoroElapsed(_DESC, ACTIVE, WALL, _UNIT, _suspensions, _migrations);
+  }
+};
+
+} // namespace warp::timer
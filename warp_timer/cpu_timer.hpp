@@ -0,0 +1,135 @@
+#pragma once
+
+#include "misc.hpp"
+#include "timer.hpp"
+
+#include "warp_log/tag.hpp"
+#include "warp_log/logger.hpp"
+
+#include <ctime>
+#include <cstdint>
+#include <charconv>
+#include <algorithm>
+#include <string_view>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#endif
+
+namespace warp::timer::internal {
+
+/// --- Thread usage utils ---
+
+/// Counters of the calling thread, fields are 0 where the OS does not provide them
+struct ThreadUsage {
+  uint64_t cpu_ns       {0};
+  uint64_t run_delay_ns {0}; // time spent runnable but waiting for a CPU
+  uint64_t voluntary    {0}; // context switches : blocked on I/O, locks, sleeps
+  uint64_t involuntary  {0}; // context switches : preempted
+  bool     has_delay    {false};
+};
+
+/// Reads the second field of `/proc/thread-self/schedstat` without allocating
+[[nodiscard]] inline bool readRunDelayNS(uint64_t& out) noexcept {
+#ifdef __linux__
+  const int FD {::open("/proc/thread-self/schedstat", O_RDONLY | O_CLOEXEC)};
+  if (FD < 0) return false;
+
+  char buf[96];
+  const ssize_t SIZE {::read(FD, buf, sizeof(buf))};
+  ::close(FD);
+  if (SIZE <= 0) return false;
+
+  const char* const END {buf + SIZE};
+  uint64_t on_cpu_ns {0};
+  auto [ptr, err] {std::from_chars(buf, END, on_cpu_ns)};
+  if (err != std::errc {} || ptr == END) return false;
+  return std::from_chars(ptr + 1, END, out).ec == std::errc {};
+#else
+  (void)out;
+  return false;
+#endif
+}
+
+[[nodiscard]] inline ThreadUsage readThreadUsage() noexcept {
+  ThreadUsage usage {};
+
+#if defined(CLOCK_THREAD_CPUTIME_ID)
+  timespec ts {};
+  if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) == 0)
+    usage.cpu_ns = static_cast<uint64_t>(ts.tv_sec) * 1'000'000'000 + static_cast<uint64_t>(ts.tv_nsec);
+#endif
+
+#ifdef __linux__
+  rusage ru {};
+  if (getrusage(RUSAGE_THREAD, &ru) == 0) {
+    usage.voluntary   = static_cast<uint64_t>(ru.ru_nvcsw);
+    usage.involuntary = static_cast<uint64_t>(ru.ru_nivcsw);
+  }
+#endif
+
+  usage.has_delay = readRunDelayNS(usage.run_delay_ns);
+  return usage;
+}
+
+/// What a region mostly did with its wall time
+[[nodiscard]] inline constexpr std::string_view classifyRegion(double cpu, double run_delay, double blocked) noexcept {
+  if (cpu >= run_delay && cpu >= blocked) return "cpu-bound";
+  if (run_delay >= blocked)               return "preempted";
+  return "blocked";
+}
+
+inline void logCpuElapsed(std::string_view desc, double wall, TimeUnit unit, const ThreadUsage& start, const ThreadUsage& stop) {
+  static const log::Logger TIMER_LOG {log::makeColoredTag(log::ANSIFore::Blue, "[TIMER]")};
+
+  const double WALL_NS  {convertUnit(wall, unit, TimeUnit::NanoSeconds)};
+  const double CPU_NS   {static_cast<double>(stop.cpu_ns - start.cpu_ns)};
+  const double DELAY_NS {start.has_delay && stop.has_delay ? static_cast<double>(stop.run_delay_ns - start.run_delay_ns) : 0.0};
+  const double OFF_NS   {std::max(0.0, WALL_NS - CPU_NS - DELAY_NS)};
+  const double PERCENT  {WALL_NS > 0 ? 100.0 / WALL_NS : 0.0};
+
+  const DurationText WALL  {wall, unit};
+  const DurationText CPU   {CPU_NS, TimeUnit::Auto};
+  const DurationText DELAY {DELAY_NS, TimeUnit::Auto};
+  const DurationText OFF   {OFF_NS, TimeUnit::Auto};
+
+  TIMER_LOG.msg(
+    "{} : {} : {} : cpu {} {:.0f}% : runqueue {} {:.0f}% : off-cpu {} {:.0f}% : {} voluntary, {} involuntary switches\n",
+    WALL.view(), desc, classifyRegion(CPU_NS, DELAY_NS, OFF_NS),
+    CPU.view(), CPU_NS * PERCENT, DELAY.view(), DELAY_NS * PERCENT, OFF.view(), OFF_NS * PERCENT,
+    stop.voluntary - start.voluntary, stop.involuntary - start.involuntary
+  );
+}
+
+} // namespace warp::timer::internal
+
+namespace warp::timer {
+
+/// Timer that also splits the region into CPU time, run queue wait and off-CPU (blocked) time
+/// Uses CLOCK_THREAD_CPUTIME_ID, RUSAGE_THREAD and schedstat, so the region must end on the thread it started on
+class CpuTimer final : public Timer {
+private:
+  internal::ThreadUsage _usage_start {internal::readThreadUsage()};
+
+public:
+  explicit CpuTimer(std::string_view description, TimeUnit unit = TimeUnit::MilliSeconds) noexcept
+  : Timer {description, unit} {}
+
+  ~CpuTimer() noexcept { if (_is_running) stop(); }
+
+  void start() noexcept {
+    _usage_start = internal::readThreadUsage();
+    Timer::start();
+  }
+
+  void reset() noexcept { start(); }
+
+  void stop() noexcept {
+    const double WALL {_stopAndGetElapsed()};
+    internal::logCpuElapsed(_DESC, WALL, _UNIT, _usage_start, internal::readThreadUsage());
+  }
+};
+
+} // namespace warp::timer
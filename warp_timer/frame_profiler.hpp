@@ -0,0 +1,205 @@
+#pragma once
+
+#include "misc.hpp"
+
+#include "warp_log/tag.hpp"
+#include "warp_log/logger.hpp"
+
+#include <array>
+#include <chrono>
+#include <format>
+#include <string>
+#include <iterator>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+#include <string_view>
+
+namespace warp::timer {
+
+/// Records zone timings of the last FRAME_HISTORY frames of a real time loop
+/// Per frame cost is constant : zone guards add to a slot, endFrame() only compares against the budget
+class FrameProfiler {
+public:
+/// Change below constants if needed
+  static constexpr size_t FRAME_HISTORY {256};
+  static constexpr size_t MAX_ZONES     {16};
+  static constexpr size_t BLAME_ZONES   {3}; // zones named when a frame is over budget
+
+  /// Returned by addZone() once MAX_ZONES exist, its guards record nothing
+  static constexpr size_t INVALID_ZONE {MAX_ZONES};
+
+  using Clock = std::chrono::steady_clock;
+
+  /// Adds the scope's duration to `zone` in the current frame, nothing for INVALID_ZONE
+  class Zone {
+  private:
+    FrameProfiler&          _profiler;
+    const size_t            _ZONE;
+    const Clock::time_point _START;
+
+  public:
+    explicit Zone(FrameProfiler& profiler, size_t zone) noexcept
+    : _profiler {profiler}, _ZONE {zone}, _START {zone == INVALID_ZONE ? Clock::time_point {} : Clock::now()} {}
+
+    ~Zone() noexcept {
+      if (_ZONE == INVALID_ZONE) return;
+      const auto ELAPSED {std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - _START).count()};
+      _profiler._frames[_profiler._current].zone_ns[_ZONE] += static_cast<uint64_t>(ELAPSED);
+    }
+
+    Zone(const Zone&) = delete;
+    Zone& operator=(const Zone&) = delete;
+  };
+
+private:
+  struct Frame {
+    uint64_t index;
+    uint64_t total_ns;
+    uint64_t zone_ns[MAX_ZONES];
+  };
+
+  const std::string_view                  _DESC;
+  const uint64_t                          _BUDGET_NS;
+  std::array<std::string_view, MAX_ZONES> _zone_names  {};
+  size_t                                  _zone_count  {0};
+  std::array<Frame, FRAME_HISTORY>        _frames      {};
+  size_t                                  _current     {0};
+  uint64_t                                _frame       {0}; // frames ended so far
+  uint64_t                                _over        {0};
+  Clock::time_point                       _frame_start {};
+  bool                                    _in_frame    {false}; // _frames[_current] is not ended yet
+  bool                                    _warned_full {false};
+
+  [[nodiscard]] const log::Logger& _log() const {
+    static const log::Logger FRAME_LOG {log::makeColoredTag(log::ANSIFore::Blue, "[TIMER][FRAME]")};
+    return FRAME_LOG;
+  }
+
+  [[nodiscard]] size_t _recorded() const noexcept { return std::min<uint64_t>(_frame, FRAME_HISTORY); }
+
+  /// Slots of the recorded frames, without the one still in progress
+  [[nodiscard]] size_t _endedSlots(std::array<size_t, FRAME_HISTORY>& slots) const noexcept {
+    size_t count {0};
+    for (size_t f = 0; f < _recorded(); ++f)
+      if (!_in_frame || f != _current) slots[count++] = f;
+    return count;
+  }
+
+  /// Zone ids of `frame` sorted by time spent, longest first
+  [[nodiscard]] std::array<size_t, MAX_ZONES> _rankZones(const Frame& frame) const noexcept {
+    std::array<size_t, MAX_ZONES> ids {};
+    for (size_t i = 0; i < _zone_count; ++i) ids[i] = i;
+    std::sort(ids.begin(), ids.begin() + _zone_count, [&frame](size_t a, size_t b) { return frame.zone_ns[a] > frame.zone_ns[b]; });
+    return ids;
+  }
+
+  void _logFrame(const Frame& frame, size_t zones, bool as_warning) const {
+    std::string line;
+
+    const internal::DurationText TOTAL  {static_cast<double>(frame.total_ns), TimeUnit::Auto};
+    const internal::DurationText BUDGET {static_cast<double>(_BUDGET_NS), TimeUnit::Auto};
+    std::format_to(std::back_inserter(line), "{} : frame {} : {} of {} budget", _DESC, frame.index, TOTAL.view(), BUDGET.view());
+
+    const std::array<size_t, MAX_ZONES> RANKED {_rankZones(frame)};
+    for (size_t i = 0; i < std::min(zones, _zone_count); ++i) {
+      const internal::DurationText ZONE {static_cast<double>(frame.zone_ns[RANKED[i]]), TimeUnit::Auto};
+      std::format_to(std::back_inserter(line), " : {} {}", _zone_names[RANKED[i]], ZONE.view());
+    }
+
+    if (as_warning) _log().warn("{}", std::string_view {line});
+    else            _log().msg("{}", std::string_view {line});
+  }
+
+public:
+  /// Frames longer than `budget` are flagged, e.g. `std::chrono::nanoseconds {1s} / 240` for a 240 Hz tick
+  explicit FrameProfiler(std::string_view description, std::chrono::nanoseconds budget) noexcept
+  : _DESC {description}, _BUDGET_NS {static_cast<uint64_t>(budget.count())} {}
+
+  /// Logs a warning naming the slowest zones of each frame over budget
+  bool log_over_budget {true};
+
+  /// Registers a zone once at setup and returns its id, names must outlive the profiler
+  /// Past MAX_ZONES returns INVALID_ZONE and warns once
+  [[nodiscard]] size_t addZone(std::string_view name) {
+    if (_zone_count == MAX_ZONES) [[unlikely]] {
+      if (!std::exchange(_warned_full, true)) _log().warn("{} : zone {} not added, {} zones max", _DESC, name, MAX_ZONES);
+      return INVALID_ZONE;
+    }
+    _zone_names[_zone_count] = name;
+    return _zone_count++;
+  }
+
+  /// Unknown ids record nothing, like INVALID_ZONE
+  [[nodiscard]] Zone zone(size_t id) noexcept { return Zone {*this, id < _zone_count ? id : INVALID_ZONE}; }
+
+  void beginFrame() noexcept {
+    _current = _frame % FRAME_HISTORY;
+    Frame& frame {_frames[_current]};
+    frame.index    = _frame;
+    frame.total_ns = 0;
+    std::fill(std::begin(frame.zone_ns), std::end(frame.zone_ns), 0);
+    _in_frame    = true;
+    _frame_start = Clock::now();
+  }
+
+  /// Returns true if the frame went over budget
+  bool endFrame() {
+    Frame& frame {_frames[_current]};
+    frame.total_ns = static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - _frame_start).count()
+    );
+    ++_frame;
+    _in_frame = false;
+
+    if (frame.total_ns <= _BUDGET_NS) [[likely]] return false;
+
+    ++_over;
+    if (log_over_budget) _logFrame(frame, BLAME_ZONES, true);
+    return true;
+  }
+
+  /// Logs rolling p50 / p99 / max of the frame and of each zone over the recorded frames
+  void report() const {
+    std::array<size_t, FRAME_HISTORY> slots;
+    const size_t COUNT {_endedSlots(slots)};
+    if (COUNT == 0) return;
+
+    std::array<uint64_t, FRAME_HISTORY> values;
+    const auto logRow = [&](std::string_view name) {
+      std::sort(values.begin(), values.begin() + COUNT);
+      const internal::DurationText P50 {static_cast<double>(values[COUNT / 2]), TimeUnit::Auto};
+      const internal::DurationText P99 {static_cast<double>(values[(COUNT - 1) * 99 / 100]), TimeUnit::Auto};
+      const internal::DurationText MAX {static_cast<double>(values[COUNT - 1]), TimeUnit::Auto};
+      _log().msg("{} : {} : p50 {} p99 {} max {}", _DESC, name, P50.view(), P99.view(), MAX.view());
+    };
+
+    for (size_t f = 0; f < COUNT; ++f) values[f] = _frames[slots[f]].total_ns;
+    logRow("frame");
+
+    for (size_t z = 0; z < _zone_count; ++z) {
+      for (size_t f = 0; f < COUNT; ++f) values[f] = _frames[slots[f]].zone_ns[z];
+      logRow(_zone_names[z]);
+    }
+
+    _log().msg("{} : {} of {} frames over budget", _DESC, _over, _frame);
+  }
+
+  /// Logs the full zone breakdown of the `count` slowest recorded frames
+  void dumpWorstFrames(size_t count = 5) const {
+    std::array<size_t, FRAME_HISTORY> order;
+    const size_t COUNT {_endedSlots(order)};
+
+    count = std::min(count, COUNT);
+    std::partial_sort(order.begin(), order.begin() + count, order.begin() + COUNT, [this](size_t a, size_t b) {
+      return _frames[a].total_ns > _frames[b].total_ns;
+    });
+
+    for (size_t i = 0; i < count; ++i) _logFrame(_frames[order[i]], _zone_count, false);
+  }
+
+  [[nodiscard]] uint64_t getFrameCount() const noexcept { return _frame; }
+  [[nodiscard]] uint64_t getOverBudgetCount() const noexcept { return _over; }
+};
+
+} // namespace warp::timer
@@ -6,9 +6,46 @@
 
 #include "warp_log/misc.hpp"
 
+#include <vector>
+#include <cstdint>
 #include <string_view>
 #include <functional>
 
+namespace warp::timer::internal {
+
+[[nodiscard]] inline const log::Logger& hierarchyLog() {
+  static const log::Logger HIERARCHY_LOG {log::makeColoredTag(log::ANSIFore::Blue, "[TIMER][HIERARCHY]")};
+  return HIERARCHY_LOG;
+}
+
+/// One logger per sub task depth, built once, deeper tasks get a temporary one
+[[nodiscard]] inline const log::Logger* taskLog(uint8_t depth) {
+/// Change below constant if needed
+  static constexpr uint8_t MAX_CACHED_DEPTH = 16;
+
+  static const std::vector<log::Logger> TASK_LOGS {[] {
+    std::vector<log::Logger> logs;
+    logs.reserve(MAX_CACHED_DEPTH + 1);
+    for (uint8_t i = 0; i <= MAX_CACHED_DEPTH; ++i) {
+      logs.emplace_back(std::vector<log::Tag> {log::makeDepthTag(i), log::makeColoredTag(log::ANSIFore::Blue, "[TIMER][TASK]")});
+    }
+    return logs;
+  }()};
+
+  return depth <= MAX_CACHED_DEPTH ? &TASK_LOGS[depth] : nullptr;
+}
+
+template <typename Msg>
+void logTask(uint8_t depth, const Msg& msg) {
+  if (const log::Logger* TASK_LOG {taskLog(depth)}) {
+    TASK_LOG->msg(msg);
+    return;
+  }
+  log::Logger {{log::makeDepthTag(depth), log::makeColoredTag(log::ANSIFore::Blue, "[TIMER][TASK]")}}.msg(msg);
+}
+
+} // namespace warp::timer::internal
+
 namespace warp::timer {
 
 /// Measures and logs the total time taken in a hierarchical manner
@@ -18,29 +55,21 @@ private:
   uint8_t _sub_task_depth {0};
 
   void _logTimerStart() const noexcept {
-    log::Logger {log::makeColoredTag(log::ANSIFore::Blue, "[TIMER][HIERARCHY]")}.msg(_DESC);
+    internal::hierarchyLog().msg(_DESC);
   }
 
 /// --- Sub task measuring utils ---
 
   void _subTaskOpen(std::string_view desc) noexcept {
-    log::Logger {{
-      log::makeDepthTag(++_sub_task_depth),
-      log::makeColoredTag(log::ANSIFore::Blue, "[TIMER][TASK]")
-    }}.msg(desc);
+    internal::logTask(++_sub_task_depth, desc);
   }
 
   void _subTaskClose(std::string_view desc, double elapsed_ms, TimeUnit display_unit) noexcept {
     _sub_task_total += internal::convertUnit(elapsed_ms, TimeUnit::MilliSeconds, _UNIT);
-    log::Logger {{
-      log::makeDepthTag(_sub_task_depth--),
-      log::makeColoredTag(log::ANSIFore::Blue, "[TIMER][TASK]")
-    }}.msg(
-      internal::formatElapsed(
-        internal::convertUnit(elapsed_ms, TimeUnit::MilliSeconds, display_unit),
-        display_unit
-      )
-    );
+    internal::logTask(_sub_task_depth--, internal::DurationText {
+      internal::convertUnit(elapsed_ms, TimeUnit::MilliSeconds, display_unit),
+      display_unit
+    }.view());
   }
 
 public:
@@ -55,10 +84,8 @@ public:
   void reset() noexcept = delete;
 
   void stop() noexcept {
-    const double ELAPSED {_stopAndGetElapsed()};
-    log::Logger {
-      log::makeColoredTag(log::ANSIFore::Blue, "[TIMER][HIERARCHY]")
-    }.msg(internal::formatElapsed(ELAPSED, _UNIT));
+    const internal::DurationText ELAPSED {_stopAndGetElapsed(), _UNIT};
+    internal::hierarchyLog().msg(ELAPSED.view());
   }
 
 /// --- Sub task measuring ---
@@ -2,14 +2,26 @@
 
 #include "warp_log/misc.hpp"
 
-#include <string>
-#include <format>
+#include <tuple>
+#include <utility>
+#include <charconv>
 #include <cstdint>
+#include <algorithm>
+#include <string_view>
+#include <chrono>
+#include <thread>
+#include <functional>
+
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/syscall.h>
+#endif
 
 namespace warp::timer {
 
 /// Enumeration of all supported time units
-enum class TimeUnit : uint8_t { MicroSeconds, MilliSeconds, Seconds, };
+/// `Auto` values are kept in nanoseconds and printed in the most readable unit
+enum class TimeUnit : uint8_t { MicroSeconds, MilliSeconds, Seconds, NanoSeconds, Auto, };
 
 } // namespace warp::timer
 
@@ -17,36 +29,111 @@ namespace warp::timer::internal {
 
 /// --- warp::TimeUnit utils ---
 
-inline constexpr int unitID(TimeUnit u) noexcept { return static_cast<int>(u); }
+inline constexpr int unitID(TimeUnit u) noexcept {
+  return static_cast<int>(u == TimeUnit::Auto ? TimeUnit::NanoSeconds : u);
+}
 
-static inline constexpr double TABLE[3][3] {
-  {1.0,       0.001,    0.000001},
-  {1000.0,    1.0,      0.001   },
-  {1'000'000, 1000.0,   1.0     },
+static inline constexpr double TABLE[4][4] {
+  {1.0,           0.001,     0.000001,      1000.0       },
+  {1000.0,        1.0,       0.001,         1'000'000    },
+  {1'000'000,     1000.0,    1.0,           1'000'000'000},
+  {0.001,         0.000001,  0.000000001,   1.0          },
 };
 
 template <TimeUnit FromTimeUnit = TimeUnit::MilliSeconds, TimeUnit ToTimeUnit>
 inline constexpr double convertUnit(double value) noexcept {
 
-  if constexpr (FromTimeUnit == ToTimeUnit) return value;
+  if constexpr (unitID(FromTimeUnit) == unitID(ToTimeUnit)) return value;
   return value * TABLE[unitID(FromTimeUnit)][unitID(ToTimeUnit)];
 }
 
 inline double convertUnit(double val, TimeUnit from_u, TimeUnit to_u) noexcept {
-  if (from_u == to_u) return val;
+  if (unitID(from_u) == unitID(to_u)) return val;
   return val * TABLE[unitID(from_u)][unitID(to_u)];
 }
 
 inline constexpr char timeUnitPrefix(TimeUnit u) noexcept {
-  const char PREFIX_CHAR[3] { 'u', 'm', '\x00' };
+  const char PREFIX_CHAR[4] { 'u', 'm', '\x00', 'n' };
   return PREFIX_CHAR[unitID(u)];
 }
 
-/// Returns the formatted string of the given elapsed time
-[[nodiscard]] inline std::string formatElapsed(double val, TimeUnit u) noexcept {
-  return std::format(
-    "{}[{:.3f} {}s]{}", log::setColor(log::ANSIFore::Yellow), val, timeUnitPrefix(u), log::resetColor()
+/// --- Clock utils ---
+
+[[nodiscard]] inline uint64_t steadyNowNS() noexcept {
+  return static_cast<uint64_t>(
+    std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count()
   );
 }
 
+/// OS thread id where available, as shown by debuggers and `top -H`
+[[nodiscard]] inline uint64_t currentThreadID() noexcept {
+#ifdef __linux__
+  return static_cast<uint64_t>(::syscall(SYS_gettid));
+#else
+  return std::hash<std::thread::id> {}(std::this_thread::get_id());
+#endif
+}
+
+/// Picks the unit that keeps an `Auto` value (in ns) between 1 and 1000
+/// Returns the value in that unit and its suffix
+[[nodiscard]] inline constexpr std::pair<double, std::string_view> autoUnit(double ns) noexcept {
+  const double ABS_NS {ns < 0 ? -ns : ns};
+
+  if (ABS_NS < 1e3)  return {ns,         "ns"};
+  if (ABS_NS < 1e6)  return {ns / 1e3,   "us"};
+  if (ABS_NS < 1e9)  return {ns / 1e6,   "ms"};
+  if (ABS_NS < 6e10) return {ns / 1e9,   "s"};
+  return                    {ns / 6e10,  "min"};
+}
+
+/// Size of the buffer needed by formatDuration
+inline constexpr size_t DURATION_TEXT_SIZE = 64;
+
+/// Writes the colored `[value unit]` of `val` (expressed in `u`) into [first, last) and returns the end
+/// Uses std::to_chars, never allocates ; output is cut short if the buffer is too small
+inline char* formatDuration(char* first, char* last, double val, TimeUnit u) noexcept {
+  constexpr std::string_view OPEN  {"\033[33m["};
+  constexpr std::string_view CLOSE {"]\033[0m"};
+
+  std::string_view suffix;
+  int precision {3};
+
+  if (u == TimeUnit::Auto) {
+    std::tie(val, suffix) = autoUnit(val);
+    if (suffix == "ns") precision = 0;
+  } else {
+    constexpr std::string_view SUFFIX[4] {"us", "ms", "s", "ns"};
+    suffix = SUFFIX[unitID(u)];
+  }
+
+  const auto append = [&first, last](std::string_view text) {
+    const size_t COUNT {std::min(text.size(), static_cast<size_t>(last - first))};
+    first = std::copy_n(text.data(), COUNT, first);
+  };
+
+  append(OPEN);
+  const auto [END, ERR] {std::to_chars(first, last, val, std::chars_format::fixed, precision)};
+  if (ERR == std::errc {}) first = END;
+  append(" ");
+  append(suffix);
+  append(CLOSE);
+  return first;
+}
+
+/// Stack buffer holding one formatted duration
+class DurationText {
+private:
+  char  _buf[DURATION_TEXT_SIZE];
+  char* _end;
+
+public:
+  explicit DurationText(double val, TimeUnit u) noexcept
+  : _end {formatDuration(_buf, _buf + sizeof(_buf), val, u)} {}
+
+  DurationText(const DurationText&) = delete;
+  DurationText& operator=(const DurationText&) = delete;
+
+  [[nodiscard]] std::string_view view() const noexcept { return {_buf, static_cast<size_t>(_end - _buf)}; }
+};
+
 } // warp::timer::internal
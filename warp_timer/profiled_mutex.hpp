@@ -0,0 +1,208 @@
+#pragma once
+
+#include "misc.hpp"
+
+#include "warp_log/tag.hpp"
+#include "warp_log/logger.hpp"
+
+#include <bit>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <string_view>
+
+namespace warp::timer::internal {
+
+/// --- Lock statistics ---
+
+/// Durations bucketed by bit width in ns, updated with relaxed atomics
+struct DurationHistogram {
+  static constexpr size_t BUCKETS {48};
+
+  std::atomic<uint64_t> buckets[BUCKETS] {};
+  std::atomic<uint64_t> count            {0};
+  std::atomic<uint64_t> total_ns         {0};
+  std::atomic<uint64_t> max_ns           {0};
+
+  void record(uint64_t ns) noexcept {
+    buckets[std::min<size_t>(std::bit_width(ns), BUCKETS - 1)].fetch_add(1, std::memory_order_relaxed);
+    count.fetch_add(1, std::memory_order_relaxed);
+    total_ns.fetch_add(ns, std::memory_order_relaxed);
+
+    uint64_t max {max_ns.load(std::memory_order_relaxed)};
+    while (ns > max && !max_ns.compare_exchange_weak(max, ns, std::memory_order_relaxed)) {}
+  }
+
+  /// Upper bound of the bucket holding the `p` quantile, in ns
+  [[nodiscard]] double quantile(double p) const noexcept {
+    const uint64_t COUNT {count.load(std::memory_order_relaxed)};
+    if (COUNT == 0) return 0.0;
+
+    const auto TARGET {static_cast<uint64_t>(p * static_cast<double>(COUNT - 1))};
+    uint64_t seen {0};
+    for (size_t i = 0; i < BUCKETS; ++i) {
+      seen += buckets[i].load(std::memory_order_relaxed);
+      if (seen > TARGET) return i == 0 ? 0.0 : static_cast<double>((uint64_t {1} << i) - 1);
+    }
+    return static_cast<double>(max_ns.load(std::memory_order_relaxed));
+  }
+};
+
+/// Aggregated statistics of every ProfiledMutex sharing one name
+struct LockStats {
+  const std::string     NAME;
+  std::atomic<uint64_t> acquisitions {0};
+  DurationHistogram     wait         {}; // contended acquisitions only
+  DurationHistogram     hold         {}; // exclusive holds only
+
+  explicit LockStats(std::string_view name) : NAME {name} {}
+};
+
+/// Owns every LockStats for the process lifetime so reports outlive the mutexes
+class LockRegistry {
+private:
+  std::mutex                              _mutex;
+  std::vector<std::unique_ptr<LockStats>> _locks;
+
+public:
+  [[nodiscard]] LockStats& find(std::string_view name) {
+    std::scoped_lock lock {_mutex};
+    for (const auto& STATS : _locks) if (STATS->NAME == name) return *STATS;
+    return *_locks.emplace_back(std::make_unique<LockStats>(name));
+  }
+
+  template <typename Fn>
+  void forEach(Fn&& fn) {
+    std::scoped_lock lock {_mutex};
+    for (const auto& STATS : _locks) fn(*STATS);
+  }
+};
+
+[[nodiscard]] inline LockRegistry& lockRegistry() {
+  static LockRegistry s_registry {};
+  return s_registry;
+}
+
+[[nodiscard]] inline uint64_t elapsedNS(std::chrono::steady_clock::time_point since) noexcept {
+  return static_cast<uint64_t>(
+    std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - since).count()
+  );
+}
+
+template <typename M>
+concept SharedLockable = requires (M m) {
+  m.lock_shared();
+  m.try_lock_shared();
+  m.unlock_shared();
+};
+
+} // namespace warp::timer::internal
+
+namespace warp::timer {
+
+/// --- Profiled mutex ---
+
+/// Drop-in for std::mutex / std::shared_mutex recording wait and hold times under `name`
+/// Tries the lock first : uncontended acquisitions pay no wait timing
+/// Shared acquisitions record their wait only, as several readers hold at once
+template <typename M = std::mutex>
+class ProfiledMutex {
+private:
+  using Clock = std::chrono::steady_clock;
+
+  M                    _mutex;
+  internal::LockStats& _stats;
+  Clock::time_point    _acquired {};
+
+  void _onAcquired(Clock::time_point now) noexcept {
+    _acquired = now;
+    _stats.acquisitions.fetch_add(1, std::memory_order_relaxed);
+  }
+
+public:
+  explicit ProfiledMutex(std::string_view name) : _stats {internal::lockRegistry().find(name)} {}
+
+  ProfiledMutex(const ProfiledMutex&) = delete;
+  ProfiledMutex& operator=(const ProfiledMutex&) = delete;
+
+  void lock() {
+    if (_mutex.try_lock()) [[likely]] {
+      _onAcquired(Clock::now());
+      return;
+    }
+
+    const Clock::time_point START {Clock::now()};
+    _mutex.lock();
+    const Clock::time_point NOW {Clock::now()};
+    _stats.wait.record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(NOW - START).count()));
+    _onAcquired(NOW);
+  }
+
+  [[nodiscard]] bool try_lock() {
+    if (!_mutex.try_lock()) return false;
+    _onAcquired(Clock::now());
+    return true;
+  }
+
+  void unlock() {
+    const uint64_t HELD_NS {internal::elapsedNS(_acquired)};
+    _mutex.unlock();
+    _stats.hold.record(HELD_NS);
+  }
+
+  void lock_shared() requires internal::SharedLockable<M> {
+    _stats.acquisitions.fetch_add(1, std::memory_order_relaxed);
+    if (_mutex.try_lock_shared()) [[likely]] return;
+
+    const Clock::time_point START {Clock::now()};
+    _mutex.lock_shared();
+    _stats.wait.record(internal::elapsedNS(START));
+  }
+
+  [[nodiscard]] bool try_lock_shared() requires internal::SharedLockable<M> {
+    if (!_mutex.try_lock_shared()) return false;
+    _stats.acquisitions.fetch_add(1, std::memory_order_relaxed);
+    return true;
+  }
+
+  void unlock_shared() requires internal::SharedLockable<M> { _mutex.unlock_shared(); }
+
+  [[nodiscard]] const internal::LockStats& getStats() const noexcept { return _stats; }
+};
+
+/// Logs the `top` locks with the most total wait time
+inline void reportContention(size_t top = 10) {
+  static const log::Logger LOCK_LOG {log::makeColoredTag(log::ANSIFore::Blue, "[TIMER][LOCKS]")};
+
+  std::vector<const internal::LockStats*> locks;
+  internal::lockRegistry().forEach([&locks](const internal::LockStats& stats) { locks.push_back(&stats); });
+
+  std::sort(locks.begin(), locks.end(), [](const internal::LockStats* a, const internal::LockStats* b) {
+    return a->wait.total_ns.load(std::memory_order_relaxed) > b->wait.total_ns.load(std::memory_order_relaxed);
+  });
+  if (locks.size() > top) locks.resize(top);
+
+  for (const internal::LockStats* stats : locks) {
+    const uint64_t ACQUIRED  {stats->acquisitions.load(std::memory_order_relaxed)};
+    const uint64_t CONTENDED {stats->wait.count.load(std::memory_order_relaxed)};
+
+    const internal::DurationText WAIT_TOTAL {static_cast<double>(stats->wait.total_ns.load()), TimeUnit::Auto};
+    const internal::DurationText WAIT_P99   {stats->wait.quantile(0.99), TimeUnit::Auto};
+    const internal::DurationText WAIT_MAX   {static_cast<double>(stats->wait.max_ns.load()), TimeUnit::Auto};
+    const internal::DurationText HOLD_P50   {stats->hold.quantile(0.50), TimeUnit::Auto};
+    const internal::DurationText HOLD_P99   {stats->hold.quantile(0.99), TimeUnit::Auto};
+
+    LOCK_LOG.msg(
+      "{} : {} acquisitions, {:.1f}% contended : wait total {} p99 {} max {} : hold p50 {} p99 {}",
+      stats->NAME, ACQUIRED, ACQUIRED ? 100.0 * static_cast<double>(CONTENDED) / static_cast<double>(ACQUIRED) : 0.0,
+      WAIT_TOTAL.view(), WAIT_P99.view(), WAIT_MAX.view(), HOLD_P50.view(), HOLD_P99.view()
+    );
+  }
+}
+
+} // namespace warp::timer
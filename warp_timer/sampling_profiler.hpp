@@ -0,0 +1,362 @@
+#pragma once
+
+#include "misc.hpp"
+
+#include "warp_log/tag.hpp"
+#include "warp_log/logger.hpp"
+
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <algorithm>
+
+#if !defined(_WIN32) && __has_include(<execinfo.h>)
+#define WARP_SAMPLING_PROFILER 1
+#include <cerrno>
+#include <cstdio>
+#include <csignal>
+#include <cstdlib>
+#include <ctime>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <sys/time.h>
+#if __has_include(<cxxabi.h>)
+#include <cxxabi.h>
+#endif
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/syscall.h>
+#ifndef sigev_notify_thread_id
+#define sigev_notify_thread_id _sigev_un._tid
+#endif
+#endif
+#else
+#define WARP_SAMPLING_PROFILER 0
+#endif
+
+namespace warp::timer::internal {
+
+/// --- Sampling profiler storage ---
+
+/// Change below constants if needed
+inline constexpr size_t SAMPLE_MAX_DEPTH        {48};
+inline constexpr size_t SAMPLE_DEFAULT_CAPACITY {16384};
+inline constexpr int    SAMPLE_SKIPPED_FRAMES   {2}; // signal handler and kernel trampoline
+
+/// Raw return addresses of one sample, `depth` is published last
+struct Sample {
+  std::atomic<uint32_t> depth {0};
+  void*                 frames[SAMPLE_MAX_DEPTH];
+};
+
+/// Preallocated samples, filled from the signal handler with a single fetch_add
+/// `in_handler` counts handlers past their entry, the buffer is only replaced once it drops to 0
+struct SampleBuffer {
+  Sample*               samples    {nullptr};
+  size_t                capacity   {0};
+  uint32_t              hz         {0};
+  uint64_t              cpu_ns     {0}; // process CPU time of the run : at start, then its length once stopped
+  std::atomic<size_t>   next       {0};
+  std::atomic<size_t>   dropped    {0};
+  std::atomic<uint64_t> handler_ns {0}; // CPU time spent in the handler, backs the overhead report
+  std::atomic<uint32_t> in_handler {0};
+  std::atomic<bool>     active     {false};
+};
+
+inline constinit SampleBuffer s_samples {};
+
+[[nodiscard]] inline const log::Logger& samplerLog() {
+  static const log::Logger SAMPLER_LOG {log::makeColoredTag(log::ANSIFore::Blue, "[TIMER][SAMPLER]")};
+  return SAMPLER_LOG;
+}
+
+#if WARP_SAMPLING_PROFILER
+
+/// Period of `hz`, split so that tv_nsec stays below one second ; 0 Hz gives a disarmed timer
+[[nodiscard]] inline timespec samplePeriod(uint32_t hz) noexcept {
+  if (hz == 0) return {};
+  const uint64_t NS {1'000'000'000ULL / hz};
+  return {static_cast<time_t>(NS / 1'000'000'000), static_cast<long>(NS % 1'000'000'000)};
+}
+
+[[nodiscard]] inline uint64_t cpuNS(clockid_t clock) noexcept {
+  timespec now {};
+  clock_gettime(clock, &now);
+  return static_cast<uint64_t>(now.tv_sec) * 1'000'000'000ULL + static_cast<uint64_t>(now.tv_nsec);
+}
+
+/// Announces itself before reading `active`, so startSampling() can wait for late handlers of a stopped run
+inline void onSampleSignal(int) noexcept {
+  s_samples.in_handler.fetch_add(1);
+  if (!s_samples.active.load()) {
+    s_samples.in_handler.fetch_sub(1);
+    return;
+  }
+
+  const int SAVED_ERRNO {errno};
+  const uint64_t START_NS {cpuNS(CLOCK_THREAD_CPUTIME_ID)};
+
+  const size_t INDEX {s_samples.next.fetch_add(1, std::memory_order_relaxed)};
+  if (INDEX < s_samples.capacity) {
+    Sample& sample {s_samples.samples[INDEX]};
+    const int DEPTH {backtrace(sample.frames, SAMPLE_MAX_DEPTH)};
+    sample.depth.store(static_cast<uint32_t>(DEPTH > 0 ? DEPTH : 0), std::memory_order_release);
+  } else {
+    s_samples.dropped.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  s_samples.handler_ns.fetch_add(cpuNS(CLOCK_THREAD_CPUTIME_ID) - START_NS, std::memory_order_relaxed);
+  errno = SAVED_ERRNO;
+  s_samples.in_handler.fetch_sub(1);
+}
+
+#ifdef __linux__
+struct ThreadSampleTimer;
+
+/// Every thread opted into sampling, so start / stop reach all of them
+struct SampleTimerRegistry {
+  std::mutex                      mutex;
+  std::vector<ThreadSampleTimer*> timers;
+  uint32_t                        hz {0}; // 0 while stopped
+};
+
+[[nodiscard]] inline SampleTimerRegistry& sampleTimers() {
+  static SampleTimerRegistry s_registry {};
+  return s_registry;
+}
+
+/// CPU time timer of one thread, signalling only that thread
+/// Created when the thread registers, then armed and disarmed from any thread by start / stop
+struct ThreadSampleTimer {
+  timer_t  id         {};
+  uint64_t thread_id  {0};
+  bool     registered {false};
+
+  /// Sets the period of the timer, logs and returns false on failure
+  bool set(uint32_t hz) noexcept {
+    const timespec   PERIOD {samplePeriod(hz)};
+    const itimerspec SPEC   {PERIOD, PERIOD};
+    if (timer_settime(id, 0, &SPEC, nullptr) == 0) return true;
+
+    samplerLog().err("timer_settime at {} Hz failed on thread {} : {}", hz, thread_id, std::strerror(errno));
+    return false;
+  }
+
+  /// Registers the calling thread, armed at once if sampling is running
+  bool join() {
+    if (registered) return true;
+
+    thread_id = static_cast<uint64_t>(::syscall(SYS_gettid));
+    sigevent event {};
+    event.sigev_notify           = SIGEV_THREAD_ID;
+    event.sigev_signo            = SIGPROF;
+    event.sigev_notify_thread_id = static_cast<pid_t>(thread_id);
+    if (timer_create(CLOCK_THREAD_CPUTIME_ID, &event, &id) != 0) {
+      samplerLog().err("timer_create failed on thread {} : {}", thread_id, std::strerror(errno));
+      return false;
+    }
+
+    SampleTimerRegistry& registry {sampleTimers()};
+    std::scoped_lock lock {registry.mutex};
+    registry.timers.push_back(this);
+    registered = true;
+    return registry.hz == 0 || set(registry.hz);
+  }
+
+  void leave() {
+    if (!registered) return;
+
+    SampleTimerRegistry& registry {sampleTimers()};
+    {
+      std::scoped_lock lock {registry.mutex};
+      std::erase(registry.timers, this);
+    }
+    timer_delete(id);
+    registered = false;
+  }
+
+  ~ThreadSampleTimer() { leave(); }
+};
+
+inline thread_local ThreadSampleTimer tl_sample_timer {};
+
+/// Arms (`hz` > 0) or disarms every registered thread, returns false if any of them failed
+inline bool setAllSampleTimers(uint32_t hz) {
+  SampleTimerRegistry& registry {sampleTimers()};
+  std::scoped_lock lock {registry.mutex};
+  registry.hz = hz;
+
+  bool all {true};
+  for (ThreadSampleTimer* timer : registry.timers) all &= timer->set(hz);
+  return all;
+}
+#endif
+
+[[nodiscard]] inline std::string frameName(void* addr) {
+  Dl_info info {};
+  if (dladdr(addr, &info) == 0 || info.dli_sname == nullptr) {
+    char buf[2 + 2 * sizeof(void*) + 1];
+    std::snprintf(buf, sizeof(buf), "%p", addr);
+    return buf;
+  }
+
+#if __has_include(<cxxabi.h>)
+  int status {0};
+  char* demangled {abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status)};
+  if (status == 0 && demangled) {
+    std::string name {demangled};
+    std::free(demangled);
+    return name;
+  }
+#endif
+  return info.dli_sname;
+}
+
+#endif // WARP_SAMPLING_PROFILER
+
+} // namespace warp::timer::internal
+
+namespace warp::timer {
+
+/// --- Sampling profiler ---
+
+/// Starts sampling every thread registered with SampledThread, plus the calling one, at `hz` per CPU second
+/// Threads may register before or after this call ; outside Linux a process wide ITIMER_PROF samples every thread
+/// Returns false, after logging why, if a timer could not be armed
+inline bool startSampling(uint32_t hz = 1000, size_t capacity = internal::SAMPLE_DEFAULT_CAPACITY) {
+#if WARP_SAMPLING_PROFILER
+  internal::SampleBuffer& buf {internal::s_samples};
+  if (buf.active.load() || hz == 0) return false;
+
+  // `active` is false : a SIGPROF still pending from the last run returns without touching the buffer,
+  // one that already passed that check is waited for before its samples are freed
+  while (buf.in_handler.load() != 0) {}
+
+  if (buf.capacity < capacity) {
+    delete[] buf.samples;
+    buf.samples  = new internal::Sample[capacity];
+    buf.capacity = capacity;
+  }
+  buf.hz     = hz;
+  buf.cpu_ns = internal::cpuNS(CLOCK_PROCESS_CPUTIME_ID);
+  buf.next.store(0);
+  buf.dropped.store(0);
+  buf.handler_ns.store(0);
+  for (size_t i = 0; i < buf.capacity; ++i) buf.samples[i].depth.store(0, std::memory_order_relaxed);
+
+  void* warm_up[1];
+  (void)backtrace(warm_up, 1); // loads the unwinder outside of the signal handler
+
+  struct sigaction action {};
+  action.sa_handler = internal::onSampleSignal;
+  sigemptyset(&action.sa_mask);
+  action.sa_flags = SA_RESTART;
+  if (sigaction(SIGPROF, &action, nullptr) != 0) {
+    internal::samplerLog().err("installing the SIGPROF handler failed : {}", std::strerror(errno));
+    return false;
+  }
+
+  buf.active.store(true);
+
+#ifdef __linux__
+  const bool JOINED {internal::tl_sample_timer.join()};
+  const bool ARMED  {internal::setAllSampleTimers(hz)};
+  return JOINED && ARMED;
+#else
+  const timespec  PERIOD {internal::samplePeriod(hz)};
+  const timeval   TV     {PERIOD.tv_sec, static_cast<suseconds_t>(PERIOD.tv_nsec / 1000)};
+  const itimerval SPEC   {TV, TV};
+  if (setitimer(ITIMER_PROF, &SPEC, nullptr) == 0) return true;
+
+  internal::samplerLog().err("setitimer at {} Hz failed : {}", hz, std::strerror(errno));
+  buf.active.store(false);
+  return false;
+#endif
+#else
+  (void)hz, (void)capacity;
+  return false;
+#endif
+}
+
+/// Stops recording on every thread, collected samples are kept until the next startSampling()
+inline void stopSampling() {
+#if WARP_SAMPLING_PROFILER
+  if (!internal::s_samples.active.exchange(false)) return;
+  internal::s_samples.cpu_ns = internal::cpuNS(CLOCK_PROCESS_CPUTIME_ID) - internal::s_samples.cpu_ns;
+#ifdef __linux__
+  (void)internal::setAllSampleTimers(0);
+#else
+  const itimerval OFF {};
+  setitimer(ITIMER_PROF, &OFF, nullptr);
+#endif
+#endif
+}
+
+/// Opts the current thread into sampling for its lifetime (Linux per thread CPU timers)
+/// Sampled whenever sampling runs, whether it started before or after this guard
+class SampledThread {
+public:
+  explicit SampledThread() {
+#if WARP_SAMPLING_PROFILER && defined(__linux__)
+    (void)internal::tl_sample_timer.join();
+#endif
+  }
+
+  ~SampledThread() {
+#if WARP_SAMPLING_PROFILER && defined(__linux__)
+    internal::tl_sample_timer.leave();
+#endif
+  }
+
+  SampledThread(const SampledThread&) = delete;
+  SampledThread& operator=(const SampledThread&) = delete;
+};
+
+/// Symbolizes the collected samples and writes them as `root;caller;leaf count` lines
+/// The output feeds flamegraph.pl or speedscope directly ; call it after stopSampling()
+inline void writeFoldedStacks(std::ostream& os) {
+#if WARP_SAMPLING_PROFILER
+  const internal::SampleBuffer& BUF {internal::s_samples};
+  const size_t COUNT {std::min(BUF.next.load(), BUF.capacity)};
+
+  std::map<void*, std::string> names;
+  std::map<std::string, size_t> stacks;
+  std::string folded;
+
+  for (size_t i = 0; i < COUNT; ++i) {
+    const internal::Sample& SAMPLE {BUF.samples[i]};
+    const int DEPTH {static_cast<int>(SAMPLE.depth.load(std::memory_order_acquire))};
+    if (DEPTH <= internal::SAMPLE_SKIPPED_FRAMES) continue;
+
+    folded.clear();
+    for (int f = DEPTH - 1; f >= internal::SAMPLE_SKIPPED_FRAMES; --f) {
+      auto [it, inserted] {names.try_emplace(SAMPLE.frames[f])};
+      if (inserted) it->second = internal::frameName(SAMPLE.frames[f]);
+      if (!folded.empty()) folded.push_back(';');
+      folded.append(it->second);
+    }
+    ++stacks[folded];
+  }
+
+  for (const auto& [STACK, HITS] : stacks) os << STACK << ' ' << HITS << '\n';
+
+  // Measured, not estimated : CPU time spent in the handler over the process CPU time of the run
+  const size_t                 TAKEN      {BUF.next.load()};
+  const double                 HANDLER_NS {static_cast<double>(BUF.handler_ns.load())};
+  const internal::DurationText PER_SAMPLE {TAKEN ? HANDLER_NS / static_cast<double>(TAKEN) : 0.0, TimeUnit::Auto};
+  internal::samplerLog().msg(
+    "{} samples, {} unique stacks, {} dropped : {} per sample, {:.2f}% of the run's CPU time at {} Hz",
+    COUNT, stacks.size(), BUF.dropped.load(), PER_SAMPLE.view(),
+    BUF.cpu_ns ? 100.0 * HANDLER_NS / static_cast<double>(BUF.cpu_ns) : 0.0, BUF.hz
+  );
+#else
+  (void)os;
+#endif
+}
+
+} // namespace warp::timer
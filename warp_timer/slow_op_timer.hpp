@@ -0,0 +1,137 @@
+#pragma once
+
+#include "misc.hpp"
+
+#include "warp_log/tag.hpp"
+#include "warp_log/logger.hpp"
+
+#include <bit>
+#include <chrono>
+#include <algorithm>
+#include <cstdint>
+#include <string_view>
+
+namespace warp::timer::internal {
+
+/// --- Slow operation statistics ---
+
+/// Per thread durations of the slow runs of one SlowOpTimer description
+struct SlowOpStats {
+/// Change below constants if needed
+  static constexpr size_t               RECENT_CAPACITY {16};
+  static constexpr std::chrono::seconds RECENT_WINDOW   {60};
+
+  using Clock = std::chrono::steady_clock;
+
+  uint64_t          key                     {0}; // hash of the description, 0 while the slot is free
+  uint64_t          count                   {0};
+  uint32_t          buckets[65]             {}; // by bit width of the duration in ns
+  Clock::time_point recent[RECENT_CAPACITY] {}; // last slow occurrences
+  uint8_t           recent_head             {0};
+
+  void record(uint64_t ns) noexcept {
+    ++count;
+    ++buckets[std::bit_width(ns)];
+  }
+
+  /// Share of recorded durations below `ns`, in percent
+  [[nodiscard]] double percentileRank(uint64_t ns) const noexcept {
+    const auto BUCKET {static_cast<int>(std::bit_width(ns))};
+    uint64_t below {0};
+    for (int i = 0; i < BUCKET; ++i) below += buckets[i];
+    return 100.0 * (static_cast<double>(below) + 0.5 * static_cast<double>(buckets[BUCKET])) / static_cast<double>(count);
+  }
+
+  /// Records a slow occurrence at `now`, returns how many happened within RECENT_WINDOW
+  [[nodiscard]] size_t markSlow(Clock::time_point now) noexcept {
+    recent[recent_head] = now;
+    recent_head = static_cast<uint8_t>((recent_head + 1) % RECENT_CAPACITY);
+
+    size_t in_window {0};
+    for (const Clock::time_point& AT : recent) in_window += (AT != Clock::time_point {} && now - AT <= RECENT_WINDOW);
+    return in_window;
+  }
+};
+
+/// FNV-1a of the description, so equal texts share stats whatever buffer holds them
+[[nodiscard]] inline constexpr uint64_t slowOpKey(std::string_view desc) noexcept {
+  uint64_t hash {0xCBF29CE484222325};
+  for (const char C : desc) hash = (hash ^ static_cast<uint8_t>(C)) * 0x100000001B3;
+  return hash ? hash : 1;
+}
+
+/// Small per thread table of stats, keyed by the contents of the description
+struct SlowOpTable {
+/// Change below constant if needed
+  static constexpr size_t CAPACITY {16};
+
+  SlowOpStats slots[CAPACITY] {};
+
+  /// nullptr once the table is full : unrelated operations never share a slot
+  [[nodiscard]] SlowOpStats* find(uint64_t key) noexcept {
+    for (SlowOpStats& stats : slots) {
+      if (stats.key == key) return &stats;
+      if (stats.key == 0) { stats.key = key; return &stats; }
+    }
+    return nullptr;
+  }
+};
+
+inline thread_local SlowOpTable tl_slow_ops {};
+
+/// Only reached past the threshold : the stats lookup stays off the fast path
+[[gnu::cold, gnu::noinline]] inline void logSlowOp(std::string_view desc, uint64_t elapsed_ns, uint64_t threshold_ns) {
+  static const log::Logger SLOW_LOG {log::makeColoredTag(log::ANSIFore::Blue, "[TIMER][SLOW]")};
+
+  const DurationText ELAPSED   {static_cast<double>(elapsed_ns), TimeUnit::Auto};
+  const DurationText THRESHOLD {static_cast<double>(threshold_ns), TimeUnit::Auto};
+
+  SlowOpStats* const STATS {tl_slow_ops.find(slowOpKey(desc))};
+  if (STATS == nullptr) {
+    SLOW_LOG.warn("{} : {} over {} : no stats, table of {} operations full on this thread", desc, ELAPSED.view(), THRESHOLD.view(), SlowOpTable::CAPACITY);
+    return;
+  }
+
+  STATS->record(elapsed_ns);
+  const size_t RECENT {STATS->markSlow(SlowOpStats::Clock::now())};
+  SLOW_LOG.warn(
+    "{} : {} over {} : p{:.1f} of {} slow runs : {} in the last {}s",
+    desc, ELAPSED.view(), THRESHOLD.view(), STATS->percentileRank(elapsed_ns), STATS->count,
+    RECENT, SlowOpStats::RECENT_WINDOW.count()
+  );
+}
+
+} // namespace warp::timer::internal
+
+namespace warp::timer {
+
+/// Timer that stays silent unless the region takes longer than `threshold`
+/// A fast run costs two clock reads and a compare, slow runs are ranked in per thread statistics
+class SlowOpTimer {
+private:
+  using Clock = internal::SlowOpStats::Clock;
+
+  const std::string_view  _DESC;
+  const uint64_t          _THRESHOLD_NS;
+  const Clock::time_point _START;
+
+public:
+  /// A negative `threshold` is clamped to 0 : every run is reported
+  explicit SlowOpTimer(std::string_view description, std::chrono::nanoseconds threshold) noexcept
+  : _DESC         {description}
+  , _THRESHOLD_NS {static_cast<uint64_t>(std::max<int64_t>(threshold.count(), 0))}
+  , _START        {Clock::now()} {}
+
+  ~SlowOpTimer() noexcept {
+    const uint64_t ELAPSED_NS {static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - _START).count())};
+
+    if (ELAPSED_NS > _THRESHOLD_NS) [[unlikely]] {
+      internal::logSlowOp(_DESC, ELAPSED_NS, _THRESHOLD_NS);
+    }
+  }
+
+  SlowOpTimer(const SlowOpTimer&) = delete;
+  SlowOpTimer& operator=(const SlowOpTimer&) = delete;
+};
+
+} // namespace warp::timer
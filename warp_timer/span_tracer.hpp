@@ -0,0 +1,325 @@
+#pragma once
+
+#include "misc.hpp"
+
+#include "warp_log/tag.hpp"
+#include "warp_log/logger.hpp"
+
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <ostream>
+#include <utility>
+#include <algorithm>
+#include <string_view>
+#include <unordered_map>
+
+namespace warp::timer {
+
+/// Identifies a span so that children can be started from any thread
+struct SpanContext {
+  uint64_t trace_id {0};
+  uint64_t span_id  {0};
+
+  [[nodiscard]] bool valid() const noexcept { return trace_id != 0; }
+};
+
+} // namespace warp::timer
+
+namespace warp::timer::internal {
+
+/// --- Span storage ---
+
+/// Change below constants if needed
+inline constexpr size_t SPAN_NAME_SIZE       {48};
+inline constexpr size_t SPAN_BUFFER_CAPACITY {4096};
+
+/// One finished span, names are truncated copies so records never allocate
+struct SpanRecord {
+  char     name[SPAN_NAME_SIZE];
+  char     category[SPAN_NAME_SIZE];
+  uint64_t trace_id;
+  uint64_t span_id;
+  uint64_t parent_id;
+  uint64_t start_ns;
+  uint64_t end_ns;
+  uint64_t begin_thread;
+  uint64_t end_thread;
+};
+
+/// Single producer ring of the thread that ended the spans, `head` publishes records and export advances `tail`
+/// Records are left uninitialized : only the pages actually written get committed
+struct SpanBuffer {
+  std::unique_ptr<SpanRecord[]> records {std::make_unique_for_overwrite<SpanRecord[]>(SPAN_BUFFER_CAPACITY)};
+  std::atomic<size_t>           head    {0};
+  std::atomic<size_t>           tail    {0};
+  std::atomic<size_t>           dropped {0}; // since the last export
+};
+
+/// Keeps every thread's buffer alive until export, even after the thread exits
+struct SpanRegistry {
+  std::mutex                               mutex;
+  std::vector<std::shared_ptr<SpanBuffer>> buffers;
+};
+
+[[nodiscard]] inline SpanRegistry& spanRegistry() {
+  static SpanRegistry s_registry {};
+  return s_registry;
+}
+
+[[nodiscard]] inline SpanBuffer& threadSpanBuffer() {
+  thread_local const std::shared_ptr<SpanBuffer> BUFFER {[] {
+    auto buffer {std::make_shared<SpanBuffer>()};
+    SpanRegistry& registry {spanRegistry()};
+    std::scoped_lock lock {registry.mutex};
+    registry.buffers.push_back(buffer);
+    return buffer;
+  }()};
+  return *BUFFER;
+}
+
+inline thread_local SpanContext tl_current_span {};
+
+/// Random looking, never zero, unique per process
+[[nodiscard]] inline uint64_t nextSpanID() noexcept {
+  static const uint64_t SEED {(static_cast<uint64_t>(std::random_device {}()) << 32) ^ steadyNowNS()};
+  static std::atomic<uint64_t> s_counter {0};
+
+  uint64_t x {SEED + 0x9E3779B97F4A7C15 * (s_counter.fetch_add(1, std::memory_order_relaxed) + 1)}; // splitmix64
+  x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9;
+  x = (x ^ (x >> 27)) * 0x94D049BB133111EB;
+  x ^= x >> 31;
+  return x ? x : 1;
+}
+
+inline void copyName(char (&out)[SPAN_NAME_SIZE], std::string_view name) noexcept {
+  const size_t SIZE {std::min(name.size(), SPAN_NAME_SIZE - 1)};
+  std::memcpy(out, name.data(), SIZE);
+  out[SIZE] = '\0';
+}
+
+inline void writeJsonString(std::ostream& os, const char* text) {
+  os << '"';
+  for (; *text; ++text) {
+    const char C {*text};
+    if (C == '"' || C == '\\')                     os << '\\' << C;
+    else if (static_cast<unsigned char>(C) < 0x20) os << ' ';
+    else                                           os << C;
+  }
+  os << '"';
+}
+
+} // namespace warp::timer::internal
+
+namespace warp::timer {
+
+/// --- Span tracing ---
+
+/// Makes `ctx` the parent of spans begun on this thread until the end of the scope
+class SpanContextScope {
+private:
+  const SpanContext _PREVIOUS;
+
+public:
+  explicit SpanContextScope(SpanContext ctx) noexcept : _PREVIOUS {internal::tl_current_span} {
+    internal::tl_current_span = ctx;
+  }
+
+  ~SpanContextScope() noexcept { internal::tl_current_span = _PREVIOUS; }
+
+  SpanContextScope(const SpanContextScope&) = delete;
+  SpanContextScope& operator=(const SpanContextScope&) = delete;
+};
+
+/// Region of work that may begin and end on different threads
+/// Recorded into the ending thread's buffer by end(), or by the destructor if end() was not called
+class Span {
+private:
+  char        _name[internal::SPAN_NAME_SIZE];
+  char        _category[internal::SPAN_NAME_SIZE];
+  SpanContext _ctx          {};
+  uint64_t    _parent_id    {0};
+  uint64_t    _start_ns     {0};
+  uint64_t    _begin_thread {0};
+  bool        _open         {false};
+
+public:
+  explicit Span(std::string_view category, std::string_view name, SpanContext parent) noexcept
+  : _ctx          {parent.valid() ? parent.trace_id : internal::nextSpanID(), internal::nextSpanID()}
+  , _parent_id    {parent.span_id}
+  , _start_ns     {internal::steadyNowNS()}
+  , _begin_thread {internal::currentThreadID()}
+  , _open         {true} {
+    internal::copyName(_name, name);
+    internal::copyName(_category, category);
+  }
+
+  Span(Span&& other) noexcept { *this = std::move(other); }
+
+  Span& operator=(Span&& other) noexcept {
+    if (this == &other) return *this;
+    end();
+    std::memcpy(_name, other._name, sizeof(_name));
+    std::memcpy(_category, other._category, sizeof(_category));
+    _ctx          = other._ctx;
+    _parent_id    = other._parent_id;
+    _start_ns     = other._start_ns;
+    _begin_thread = other._begin_thread;
+    _open         = std::exchange(other._open, false);
+    return *this;
+  }
+
+  ~Span() { end(); }
+
+  /// Ends the span on the calling thread, later calls do nothing
+  void end() {
+    if (!_open) return;
+    _open = false;
+
+    internal::SpanBuffer& buffer {internal::threadSpanBuffer()};
+    const size_t HEAD {buffer.head.load(std::memory_order_relaxed)};
+    if (HEAD - buffer.tail.load(std::memory_order_acquire) == internal::SPAN_BUFFER_CAPACITY) {
+      buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+
+    internal::SpanRecord& record {buffer.records[HEAD % internal::SPAN_BUFFER_CAPACITY]};
+    std::memcpy(record.name, _name, sizeof(_name));
+    std::memcpy(record.category, _category, sizeof(_category));
+    record.trace_id     = _ctx.trace_id;
+    record.span_id      = _ctx.span_id;
+    record.parent_id    = _parent_id;
+    record.start_ns     = _start_ns;
+    record.end_ns       = internal::steadyNowNS();
+    record.begin_thread = _begin_thread;
+    record.end_thread   = internal::currentThreadID();
+    buffer.head.store(HEAD + 1, std::memory_order_release);
+  }
+
+  /// Pass to another thread to begin children there
+  [[nodiscard]] SpanContext context() const noexcept { return _ctx; }
+};
+
+/// Named source of spans, the name is used as the trace category
+class Tracer {
+private:
+  const std::string _CATEGORY;
+
+public:
+  explicit Tracer(std::string_view category) : _CATEGORY {category} {}
+
+  /// Child of the span set by SpanContextScope on this thread, or a new trace
+  [[nodiscard]] Span begin(std::string_view name) const noexcept { return Span {_CATEGORY, name, internal::tl_current_span}; }
+
+  [[nodiscard]] Span begin(std::string_view name, SpanContext parent) const noexcept { return Span {_CATEGORY, name, parent}; }
+};
+
+/// Writes every span recorded since the last export as Chrome trace events (chrome://tracing, Perfetto)
+/// Spans ending on their begin thread are complete slices of that thread, others async slices keyed by span id
+/// Each child is linked to its parent by a flow arrow, across threads, when both are in the same export ; ids are kept in `args`
+/// Exported spans are drained : their slots are reused by the threads that recorded them
+inline void writeChromeTrace(std::ostream& os) {
+  internal::SpanRegistry& registry {internal::spanRegistry()};
+  std::scoped_lock lock {registry.mutex};
+
+  // [tail, head) of each buffer, read once so both passes see the same spans
+  std::vector<std::pair<size_t, size_t>> ranges;
+  ranges.reserve(registry.buffers.size());
+
+  uint64_t first_ns {UINT64_MAX};
+  std::unordered_map<uint64_t, const internal::SpanRecord*> by_id;
+  for (const auto& BUFFER : registry.buffers) {
+    const size_t TAIL {BUFFER->tail.load(std::memory_order_relaxed)};
+    const size_t HEAD {BUFFER->head.load(std::memory_order_acquire)};
+    ranges.emplace_back(TAIL, HEAD);
+
+    for (size_t i = TAIL; i < HEAD; ++i) {
+      const internal::SpanRecord& RECORD {BUFFER->records[i % internal::SPAN_BUFFER_CAPACITY]};
+      first_ns = std::min(first_ns, RECORD.start_ns);
+      by_id.emplace(RECORD.span_id, &RECORD);
+    }
+  }
+
+  const auto toUS = [first_ns](uint64_t ns) { return static_cast<double>(ns - first_ns) / 1000.0; };
+
+  const auto writeHead = [&os](const internal::SpanRecord& record) {
+    os << "{\"name\":";
+    internal::writeJsonString(os, record.name);
+    os << ",\"cat\":";
+    internal::writeJsonString(os, record.category);
+  };
+
+  const auto writeArgs = [&os](const internal::SpanRecord& record) {
+    os << std::format(
+      ",\"args\":{{\"trace_id\":\"{:016x}\",\"span_id\":\"{:016x}\",\"parent_id\":\"{:016x}\",\"end_tid\":{}}}}}",
+      record.trace_id, record.span_id, record.parent_id, record.end_thread
+    );
+  };
+
+  const auto writeSpan = [&](const internal::SpanRecord& record) {
+    writeHead(record);
+    if (record.begin_thread == record.end_thread) {
+      os << std::format(
+        ",\"ph\":\"X\",\"ts\":{:.3f},\"dur\":{:.3f},\"pid\":1,\"tid\":{}",
+        toUS(record.start_ns), static_cast<double>(record.end_ns - record.start_ns) / 1000.0, record.begin_thread
+      );
+      writeArgs(record);
+      return;
+    }
+
+    os << std::format(",\"ph\":\"b\",\"id\":\"0x{:x}\",\"ts\":{:.3f},\"pid\":1,\"tid\":{}", record.span_id, toUS(record.start_ns), record.begin_thread);
+    writeArgs(record);
+    os << ",\n";
+    writeHead(record);
+    os << std::format(",\"ph\":\"e\",\"id\":\"0x{:x}\",\"ts\":{:.3f},\"pid\":1,\"tid\":{}}}", record.span_id, toUS(record.end_ns), record.end_thread);
+  };
+
+  // starts inside the parent's slice, ends on the child's first instant ; keyed by the child's span id
+  const auto writeFlow = [&](const internal::SpanRecord& parent, const internal::SpanRecord& child) {
+    const uint64_t FROM_NS {std::clamp(child.start_ns, parent.start_ns, parent.end_ns)};
+    os << std::format(
+      "{{\"name\":\"parent\",\"cat\":\"span\",\"ph\":\"s\",\"id\":\"0x{:x}\",\"ts\":{:.3f},\"pid\":1,\"tid\":{}}},\n"
+      "{{\"name\":\"parent\",\"cat\":\"span\",\"ph\":\"f\",\"bp\":\"e\",\"id\":\"0x{:x}\",\"ts\":{:.3f},\"pid\":1,\"tid\":{}}}",
+      child.span_id, toUS(FROM_NS), parent.begin_thread,
+      child.span_id, toUS(child.start_ns), child.begin_thread
+    );
+  };
+
+  size_t spans {0}, flows {0}, dropped {0};
+  os << "{\"traceEvents\":[";
+  for (size_t b = 0; b < registry.buffers.size(); ++b) {
+    internal::SpanBuffer& buffer {*registry.buffers[b]};
+    const auto [TAIL, HEAD] {ranges[b]};
+    for (size_t i = TAIL; i < HEAD; ++i) {
+      const internal::SpanRecord& RECORD {buffer.records[i % internal::SPAN_BUFFER_CAPACITY]};
+      os << (spans++ || flows ? ",\n" : "\n");
+      writeSpan(RECORD);
+
+      const auto PARENT {RECORD.parent_id ? by_id.find(RECORD.parent_id) : by_id.end()};
+      if (PARENT == by_id.end()) continue;
+      os << ",\n";
+      writeFlow(*PARENT->second, RECORD);
+      ++flows;
+    }
+    buffer.tail.store(HEAD, std::memory_order_release);
+    dropped += buffer.dropped.exchange(0, std::memory_order_relaxed);
+  }
+  os << "\n]}\n";
+
+  static const log::Logger SPAN_LOG {log::makeColoredTag(log::ANSIFore::Blue, "[TIMER][SPANS]")};
+  SPAN_LOG.msg("{} spans and {} parent links exported, {} dropped", spans, flows, dropped);
+}
+
+inline void writeChromeTrace(const std::string& path) {
+  std::ofstream file {path};
+  writeChromeTrace(file);
+}
+
+} // namespace warp::timer
@@ -0,0 +1,258 @@
+#pragma once
+
+#include "misc.hpp"
+
+#include "warp_log/tag.hpp"
+#include "warp_log/logger.hpp"
+
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <cstdint>
+#include <string_view>
+#include <condition_variable>
+
+#ifndef _WIN32
+#include <csignal>
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+#if __has_include(<execinfo.h>)
+#include <execinfo.h>
+#define WARP_WATCHDOG_BACKTRACE 1
+#else
+#define WARP_WATCHDOG_BACKTRACE 0
+#endif
+
+namespace warp::timer::internal {
+
+/// --- Watchdog timer wheel ---
+
+/// Change below constants if needed
+inline constexpr uint64_t WATCHDOG_TICK_NS         {10'000'000}; // 10 ms
+inline constexpr size_t   WATCHDOG_WHEEL_SIZE      {256};
+inline constexpr size_t   WATCHDOG_SLOTS_PER_SPOKE {4};
+
+/// One registered deadline
+/// `state` packs a generation above the 3 low tag bits so a reused slot is never mistaken for the old one
+struct WatchdogSlot {
+  static constexpr uint64_t FREE      {0};
+  static constexpr uint64_t CLAIMED   {1};
+  static constexpr uint64_t ARMED     {2};
+  static constexpr uint64_t REPORTING {3}; // watchdog thread still uses the fields, disarm() waits
+  static constexpr uint64_t REPORTED  {4};
+  static constexpr uint64_t TAG_MASK  {7};
+
+  std::atomic<uint64_t>    state       {FREE};
+  std::atomic<uint64_t>    start_ns    {0};
+  std::atomic<uint64_t>    deadline_ns {0};
+  std::atomic<const char*> desc        {nullptr};
+  std::atomic<size_t>      desc_size   {0};
+  std::atomic<uint64_t>    thread_id   {0};
+#ifndef _WIN32
+  std::atomic<pthread_t>   native      {};
+#endif
+
+  [[nodiscard]] static constexpr uint64_t tagOf(uint64_t word) noexcept { return word & TAG_MASK; }
+  [[nodiscard]] static constexpr uint64_t with(uint64_t word, uint64_t tag) noexcept { return (word & ~TAG_MASK) | tag; }
+};
+
+/// Deadlines hashed by expiry tick into spokes, scanned one spoke per tick by a single thread
+/// Guards claim and release slots with CAS only ; a full spoke spills into the next ones
+class Watchdog {
+private:
+  WatchdogSlot            _wheel[WATCHDOG_WHEEL_SIZE][WATCHDOG_SLOTS_PER_SPOKE] {};
+  std::atomic<bool>       _backtrace {false};
+  std::atomic<bool>       _stop      {false};
+  std::mutex              _wake_mutex;
+  std::condition_variable _wake;
+  const log::Logger       _LOG       {log::makeColoredTag(log::ANSIFore::Blue, "[TIMER][WATCHDOG]")};
+  std::thread             _thread;
+
+  void _report(WatchdogSlot& slot, uint64_t word, uint64_t now) {
+    const uint64_t         START    {slot.start_ns.load(std::memory_order_relaxed)};
+    const uint64_t         DEADLINE {slot.deadline_ns.load(std::memory_order_relaxed)};
+    const std::string_view DESC     {slot.desc.load(std::memory_order_relaxed), slot.desc_size.load(std::memory_order_relaxed)};
+    const uint64_t         THREAD   {slot.thread_id.load(std::memory_order_relaxed)};
+#ifndef _WIN32
+    const pthread_t        NATIVE   {slot.native.load(std::memory_order_relaxed)};
+#endif
+
+    // fields are only trusted if the slot still holds the same registration
+    // while REPORTING the guard cannot return from disarm(), so its thread is alive for pthread_kill
+    if (!slot.state.compare_exchange_strong(word, WatchdogSlot::with(word, WatchdogSlot::REPORTING), std::memory_order_acquire)) return;
+
+#if !defined(_WIN32) && WARP_WATCHDOG_BACKTRACE
+    if (_backtrace.load(std::memory_order_relaxed)) pthread_kill(NATIVE, SIGUSR2);
+#endif
+
+    const DurationText ELAPSED {static_cast<double>(now - START), TimeUnit::Auto};
+    const DurationText LIMIT   {static_cast<double>(DEADLINE - START), TimeUnit::Auto};
+    _LOG.warn("{} : stalled for {} past its {} deadline on thread {}", DESC, ELAPSED.view(), LIMIT.view(), THREAD);
+
+    slot.state.store(WatchdogSlot::with(word, WatchdogSlot::REPORTED), std::memory_order_release);
+  }
+
+  void _scanSpoke(size_t spoke, uint64_t now) {
+    for (WatchdogSlot& slot : _wheel[spoke]) {
+      const uint64_t WORD {slot.state.load(std::memory_order_acquire)};
+      if (WatchdogSlot::tagOf(WORD) != WatchdogSlot::ARMED) continue;
+      if (slot.deadline_ns.load(std::memory_order_relaxed) > now) continue; // later turn of the wheel
+      _report(slot, WORD, now);
+    }
+  }
+
+  void _run() {
+    uint64_t last_tick {steadyNowNS() / WATCHDOG_TICK_NS};
+
+    std::unique_lock lock {_wake_mutex};
+    while (!_wake.wait_for(lock, std::chrono::nanoseconds {WATCHDOG_TICK_NS}, [this] { return _stop.load(); })) {
+      const uint64_t NOW  {steadyNowNS()};
+      const uint64_t TICK {NOW / WATCHDOG_TICK_NS};
+
+      const uint64_t FIRST {TICK - last_tick > WATCHDOG_WHEEL_SIZE ? TICK - WATCHDOG_WHEEL_SIZE : last_tick};
+      for (uint64_t t = FIRST; t <= TICK; ++t) _scanSpoke(t % WATCHDOG_WHEEL_SIZE, NOW);
+      last_tick = TICK; // the current spoke can still be armed for this tick
+    }
+  }
+
+public:
+  explicit Watchdog() : _thread {[this] { _run(); }} {}
+
+  ~Watchdog() {
+    {
+      std::scoped_lock lock {_wake_mutex};
+      _stop.store(true);
+    }
+    _wake.notify_one();
+    _thread.join();
+  }
+
+  Watchdog(const Watchdog&) = delete;
+  Watchdog& operator=(const Watchdog&) = delete;
+
+  /// Returns the claimed slot and its state word, or nullptr if the wheel is full
+  [[nodiscard]] WatchdogSlot* arm(std::string_view desc, uint64_t start_ns, uint64_t deadline_ns, uint64_t& word) noexcept {
+    const size_t SPOKE {(deadline_ns / WATCHDOG_TICK_NS) % WATCHDOG_WHEEL_SIZE};
+
+    for (size_t probe = 0; probe < WATCHDOG_WHEEL_SIZE; ++probe) {
+      for (WatchdogSlot& slot : _wheel[(SPOKE + probe) % WATCHDOG_WHEEL_SIZE]) {
+        uint64_t free_word {slot.state.load(std::memory_order_relaxed)};
+        if (WatchdogSlot::tagOf(free_word) != WatchdogSlot::FREE) continue;
+
+        const uint64_t CLAIMED_WORD {WatchdogSlot::with(free_word + WatchdogSlot::TAG_MASK + 1, WatchdogSlot::CLAIMED)}; // next generation
+        if (!slot.state.compare_exchange_strong(free_word, CLAIMED_WORD, std::memory_order_acquire)) continue;
+
+        slot.start_ns.store(start_ns, std::memory_order_relaxed);
+        slot.deadline_ns.store(deadline_ns, std::memory_order_relaxed);
+        slot.desc.store(desc.data(), std::memory_order_relaxed);
+        slot.desc_size.store(desc.size(), std::memory_order_relaxed);
+        slot.thread_id.store(currentThreadID(), std::memory_order_relaxed);
+#ifndef _WIN32
+        slot.native.store(pthread_self(), std::memory_order_relaxed);
+#endif
+        word = WatchdogSlot::with(CLAIMED_WORD, WatchdogSlot::ARMED);
+        slot.state.store(word, std::memory_order_release);
+        return &slot;
+      }
+    }
+    return nullptr;
+  }
+
+  /// Frees the slot, logs once more if the region had been reported as stalled
+  /// Waits while the watchdog thread is reporting it, which takes one log line
+  void disarm(WatchdogSlot& slot, uint64_t word, std::string_view desc, uint64_t start_ns) {
+    uint64_t prev {slot.state.load(std::memory_order_acquire)};
+    for (;;) {
+      if (WatchdogSlot::tagOf(prev) == WatchdogSlot::REPORTING) [[unlikely]] {
+        std::this_thread::yield();
+        prev = slot.state.load(std::memory_order_acquire);
+        continue;
+      }
+      if (slot.state.compare_exchange_weak(prev, WatchdogSlot::with(word, WatchdogSlot::FREE), std::memory_order_acq_rel)) break;
+    }
+    if (WatchdogSlot::tagOf(prev) != WatchdogSlot::REPORTED) return;
+
+    const DurationText ELAPSED {static_cast<double>(steadyNowNS() - start_ns), TimeUnit::Auto};
+    _LOG.msg("{} : finished after {}", desc, ELAPSED.view());
+  }
+
+  void enableBacktrace(bool enable) noexcept { _backtrace.store(enable, std::memory_order_relaxed); }
+};
+
+[[nodiscard]] inline Watchdog& watchdog() {
+  static Watchdog s_watchdog {};
+  return s_watchdog;
+}
+
+#if !defined(_WIN32) && WARP_WATCHDOG_BACKTRACE
+/// Runs on the stalled thread : only async-signal-safe calls
+inline void writeBacktrace(int) noexcept {
+  constexpr char HEADER[] {"[TIMER][WATCHDOG] : backtrace of stalled thread\n"};
+  [[maybe_unused]] const auto WRITTEN {::write(STDERR_FILENO, HEADER, sizeof(HEADER) - 1)};
+
+  void* frames[64];
+  const int COUNT {backtrace(frames, 64)};
+  backtrace_symbols_fd(frames, COUNT, STDERR_FILENO);
+}
+#endif
+
+} // namespace warp::timer::internal
+
+namespace warp::timer {
+
+/// Reports the scope from the watchdog thread while it is still running past `deadline`
+/// Descriptions must outlive the guard, string literals are expected
+class WatchdogGuard {
+private:
+  const std::string_view  _DESC;
+  const uint64_t          _START_NS;
+  uint64_t                _word {0};
+  internal::WatchdogSlot* _slot;
+
+public:
+  explicit WatchdogGuard(std::string_view description, std::chrono::nanoseconds deadline) noexcept
+  : _DESC     {description}
+  , _START_NS {internal::steadyNowNS()}
+  , _slot     {internal::watchdog().arm(_DESC, _START_NS, _START_NS + static_cast<uint64_t>(deadline.count()), _word)} {}
+
+  ~WatchdogGuard() { if (_slot) internal::watchdog().disarm(*_slot, _word, _DESC, _START_NS); }
+
+  WatchdogGuard(const WatchdogGuard&) = delete;
+  WatchdogGuard& operator=(const WatchdogGuard&) = delete;
+};
+
+/// Sends SIGUSR2 to stalled threads so they print their own backtrace to stderr
+/// Replaces the process SIGUSR2 handler while enabled, disabling restores the previous one
+/// Call it at startup, from one thread ; no-op where backtraces are unavailable
+inline void setWatchdogBacktrace(bool enable) {
+#if !defined(_WIN32) && WARP_WATCHDOG_BACKTRACE
+  static struct sigaction s_previous {};
+  static bool             s_installed {false};
+
+  if (enable && !s_installed) {
+    void* warm_up[1];
+    (void)backtrace(warm_up, 1); // first call may load libgcc and allocate : keep that out of the handler
+
+    struct sigaction action {};
+    action.sa_handler = internal::writeBacktrace;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART;
+    s_installed = sigaction(SIGUSR2, &action, &s_previous) == 0;
+    if (!s_installed) return;
+  }
+
+  internal::watchdog().enableBacktrace(enable);
+
+  if (!enable && s_installed) {
+    sigaction(SIGUSR2, &s_previous, nullptr);
+    s_installed = false;
+  }
+#else
+  (void)enable;
+#endif
+}
+
+} // namespace warp::timer